@@ -0,0 +1,105 @@
+// /LegionAura/bench/fake_hidraw.cpp
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fake_hidraw.h"
+
+LAFakeHidrawRoot::LAFakeHidrawRoot() {
+    char tmpl[] = "/tmp/legionaura_hidraw_XXXXXX";
+    if (!mkdtemp(tmpl)) return;
+    root_ = tmpl;
+    for (const char* d : {"/sys", "/sys/class", "/sys/class/hidraw", "/dev"}) {
+        ::mkdir((root_ + d).c_str(), 0755);
+        dirs_.push_back(root_ + d);
+    }
+}
+
+LAFakeHidrawRoot::~LAFakeHidrawRoot() {
+    for (auto& f : files_) std::remove(f.c_str());
+    for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) ::rmdir(it->c_str());
+    if (!root_.empty()) ::rmdir(root_.c_str());
+}
+
+static bool writeFile(const std::string& path, const void* data, size_t len) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(data, 1, len, f) == len;
+    return (std::fclose(f) == 0) && ok;
+}
+
+bool LAFakeHidrawRoot::addNode(const std::string& name, uint16_t vid, uint16_t pid,
+                               const std::vector<uint8_t>& reportDescriptor)
+{
+    if (root_.empty()) return false;
+    const std::string dir = root_ + "/sys/class/hidraw/" + name;
+    for (const std::string& d : {dir, dir + "/device"}) {
+        if (::mkdir(d.c_str(), 0755) != 0) return false;
+        dirs_.push_back(d);
+    }
+
+    char uevent[96];
+    int n = std::snprintf(uevent, sizeof uevent,
+                          "DRIVER=hid-generic\nHID_ID=0003:%08X:%08X\nHID_NAME=fake\n", vid, pid);
+    const std::string files[] = {dir + "/device/uevent", dir + "/device/report_descriptor",
+                                 root_ + "/dev/" + name};
+    bool ok = writeFile(files[0], uevent, (size_t)n) &&
+              writeFile(files[1], reportDescriptor.data(), reportDescriptor.size()) &&
+              writeFile(files[2], "", 0);
+    files_.insert(files_.end(), std::begin(files), std::end(files));
+    return ok;
+}
+
+std::vector<uint8_t> LAFakeHidrawRoot::lightingDescriptor() {
+    return {
+        0x06, 0x89, 0xFF,   // Usage Page (vendor 0xFF89)
+        0x09, 0x07,         // Usage
+        0xA1, 0x01,         // Collection (Application)
+        0x85, 0xCC,         //   Report ID 0xCC
+        0x09, 0x00,         //   Usage
+        0x15, 0x00,         //   Logical Minimum 0
+        0x26, 0xFF, 0x00,   //   Logical Maximum 255
+        0x75, 0x08,         //   Report Size 8
+        0x95, 0x1F,         //   Report Count 31
+        0xB1, 0x02,         //   Feature (Data, Var, Abs)
+        0xC0,               // End Collection
+    };
+}
+
+std::vector<uint8_t> LAFakeHidrawRoot::keyboardDescriptor() {
+    return {
+        0x05, 0x01,         // Usage Page (Generic Desktop)
+        0x09, 0x06,         // Usage (Keyboard)
+        0xA1, 0x01,         // Collection (Application)
+        0x85, 0x01,         //   Report ID 1
+        0x05, 0x07,         //   Usage Page (Keyboard)
+        0x19, 0xE0,         //   Usage Minimum
+        0x29, 0xE7,         //   Usage Maximum
+        0x75, 0x01,         //   Report Size 1
+        0x95, 0x08,         //   Report Count 8
+        0x81, 0x02,         //   Input (Data, Var, Abs)
+        0xC0,               // End Collection
+    };
+}
+
+// TRANSPORT --------------------------------------------------------
+
+std::unique_ptr<LAFakeHidraw> LAFakeHidraw::open(const std::string& devnode, std::unique_ptr<LASimIte> dev) {
+    int fd = ::open(devnode.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    return std::unique_ptr<LAFakeHidraw>(new LAFakeHidraw(fd, std::move(dev)));
+}
+
+int LAFakeHidraw::featureIoctl(bool set, uint8_t* buf, uint16_t len) {
+    // HIDIOCGFEATURE: the caller puts the report id it wants in buf[0]
+    if (buf[0] != 0xCC) { badFrames_++; return -EINVAL; }
+
+    int r = set ? dev_->setReport(buf, len, 0) : dev_->getReport(buf, len, 0);
+    if (r >= 0) return r;
+    return r == -9 ? -EPIPE : -EIO;   // stall / anything else
+}
@@ -0,0 +1,57 @@
+// LegionAura/bench/fake_hidraw.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hidraw.h"
+#include "sim_ite.h"
+
+// ------------------------------------------------------
+// A throwaway sysfs + /dev tree for LAHidrawTransport::find():
+//
+//   <root>/sys/class/hidraw/<name>/device/uevent             HID_ID=...
+//   <root>/sys/class/hidraw/<name>/device/report_descriptor
+//   <root>/dev/<name>                                        plain file
+//
+// The device nodes are ordinary files, so the ioctls are answered by
+// LAFakeHidraw below instead of the kernel.
+// ------------------------------------------------------
+class LAFakeHidrawRoot {
+public:
+    LAFakeHidrawRoot();    // fresh directory under /tmp
+    ~LAFakeHidrawRoot();   // removes it again
+    LAFakeHidrawRoot(const LAFakeHidrawRoot&) = delete;
+    LAFakeHidrawRoot& operator=(const LAFakeHidrawRoot&) = delete;
+
+    bool addNode(const std::string& name, uint16_t vid, uint16_t pid,
+                 const std::vector<uint8_t>& reportDescriptor);
+    const std::string& root() const { return root_; }
+
+    // Descriptor of the controller's lighting interface (report id 0xCC)
+    // and of one of its other interfaces
+    static std::vector<uint8_t> lightingDescriptor();
+    static std::vector<uint8_t> keyboardDescriptor();
+
+private:
+    std::string root_;
+    std::vector<std::string> files_, dirs_;   // removed files first, dirs innermost first
+};
+
+// The hidraw transport with the two ioctls forwarded to a simulated
+// controller. Checks the report id framing the kernel would see.
+class LAFakeHidraw : public LAHidrawTransport {
+public:
+    static std::unique_ptr<LAFakeHidraw> open(const std::string& devnode, std::unique_ptr<LASimIte> dev);
+
+    LASimIte& device() { return *dev_; }
+    uint64_t badFrames() const { return badFrames_; }   // buffers not starting with 0xCC
+
+protected:
+    int featureIoctl(bool set, uint8_t* buf, uint16_t len) override;
+
+private:
+    LAFakeHidraw(int fd, std::unique_ptr<LASimIte> dev) : LAHidrawTransport(fd), dev_(std::move(dev)) {}
+    std::unique_ptr<LASimIte> dev_;
+    uint64_t badFrames_ = 0;
+};
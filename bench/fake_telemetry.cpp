@@ -0,0 +1,70 @@
+// /LegionAura/bench/fake_telemetry.cpp
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fake_telemetry.h"
+
+LAFakeTelemetryRoot::LAFakeTelemetryRoot() {
+    char tmpl[] = "/tmp/legionaura_telemetry_XXXXXX";
+    if (!mkdtemp(tmpl)) return;
+    root_ = tmpl;
+    hwmon_ = root_ + "/sys/class/hwmon/hwmon0";
+    thermal_ = root_ + "/sys/class/thermal/thermal_zone0";
+    for (const std::string& d : {root_ + "/proc", root_ + "/sys", root_ + "/sys/class",
+                                 root_ + "/sys/class/hwmon", hwmon_,
+                                 root_ + "/sys/class/thermal", thermal_}) {
+        ::mkdir(d.c_str(), 0755);
+        dirs_.push_back(d);
+    }
+
+    write(hwmon_ + "/name", "coretemp\n");
+    write(hwmon_ + "/temp1_label", "Package id 0\n");
+    write(hwmon_ + "/temp2_label", "Core 0\n");
+    write(thermal_ + "/type", "acpitz\n");
+    setPackageTemp(45000);
+    setCoreTemp(44000);
+    setThermal(40000);
+    setCpus({{0, 0}, {0, 0}});
+}
+
+LAFakeTelemetryRoot::~LAFakeTelemetryRoot() {
+    for (auto& f : files_) std::remove(f.c_str());
+    for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) ::rmdir(it->c_str());
+    if (!root_.empty()) ::rmdir(root_.c_str());
+}
+
+bool LAFakeTelemetryRoot::write(const std::string& path, const std::string& text) {
+    if (root_.empty()) return false;
+    // "w" truncates the same inode, so open descriptors see the new text
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (std::find(files_.begin(), files_.end(), path) == files_.end()) files_.push_back(path);
+    return ok;
+}
+
+bool LAFakeTelemetryRoot::write(const std::string& path, int value) {
+    return write(path, std::to_string(value) + "\n");
+}
+
+bool LAFakeTelemetryRoot::setCpus(const std::vector<std::pair<uint64_t,uint64_t>>& busyIdle) {
+    // user nice system idle iowait irq softirq steal guest guest_nice;
+    // busy time goes to user, idle to idle
+    auto line = [](const std::string& tag, uint64_t busy, uint64_t idle) {
+        return tag + " " + std::to_string(busy) + " 0 0 " + std::to_string(idle) + " 0 0 0 0 0 0\n";
+    };
+    uint64_t busy = 0, idle = 0;
+    std::string cpus;
+    for (size_t k = 0; k < busyIdle.size(); ++k) {
+        busy += busyIdle[k].first;
+        idle += busyIdle[k].second;
+        cpus += line("cpu" + std::to_string(k), busyIdle[k].first, busyIdle[k].second);
+    }
+    return write(root_ + "/proc/stat", line("cpu ", busy, idle) + cpus +
+                 "intr 12345 0 9 0 0\nctxt 67890\nbtime 1700000000\n");
+}
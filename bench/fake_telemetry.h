@@ -0,0 +1,40 @@
+// LegionAura/bench/fake_telemetry.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------
+// A throwaway /proc + /sys tree for LATelemetry:
+//
+//   <root>/proc/stat                          cpu, cpu0.. lines + intr
+//   <root>/sys/class/hwmon/hwmon0/            coretemp: temp1 "Package id 0",
+//                                             temp2 "Core 0"
+//   <root>/sys/class/thermal/thermal_zone0/   acpitz
+//
+// Setters rewrite the files in place, so descriptors LATelemetry holds
+// see the new values on their next pread().
+// ------------------------------------------------------
+class LAFakeTelemetryRoot {
+public:
+    LAFakeTelemetryRoot();    // fresh directory under /tmp
+    ~LAFakeTelemetryRoot();   // removes it again
+    LAFakeTelemetryRoot(const LAFakeTelemetryRoot&) = delete;
+    LAFakeTelemetryRoot& operator=(const LAFakeTelemetryRoot&) = delete;
+
+    const std::string& root() const { return root_; }
+
+    // Cumulative (busy, idle) jiffies per CPU; the "cpu" line is the sum
+    bool setCpus(const std::vector<std::pair<uint64_t,uint64_t>>& busyIdle);
+    bool setPackageTemp(int milliC) { return write(hwmon_ + "/temp1_input", milliC); }
+    bool setCoreTemp(int milliC)    { return write(hwmon_ + "/temp2_input", milliC); }
+    bool setThermal(int milliC)     { return write(thermal_ + "/temp", milliC); }
+
+private:
+    bool write(const std::string& path, int value);
+    bool write(const std::string& path, const std::string& text);
+
+    std::string root_, hwmon_, thermal_;
+    std::vector<std::string> files_, dirs_;   // removed files first, dirs innermost first
+};
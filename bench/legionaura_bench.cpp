@@ -0,0 +1,746 @@
+//LegionAura/bench/legionaura_bench.cpp
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <linux/input.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "legionaura.h"
+#include "device_table.h"
+#include "audio.h"
+#include "ambient.h"
+#include "color.h"
+#include "io_stats.h"
+#include "device_group.h"
+#include "io_thread.h"
+#include "ipc.h"
+#include "packet.h"
+#include "profiles.h"
+#include "reactive.h"
+#include "telemetry.h"
+#include "timeline.h"
+#include "sim_ite.h"
+#include "fake_hidraw.h"
+#include "fake_telemetry.h"
+
+// Microbenchmarks for the hot paths plus end-to-end apply/readState
+// against LASimIte. Prints one JSON document so runs can be diffed.
+
+#ifndef LEGIONAURA_VERSION
+#define LEGIONAURA_VERSION "unknown"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+template <class T>
+static inline void doNotOptimize(const T& v) { asm volatile("" : : "r,m"(v) : "memory"); }
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0;     // median over samples
+    double minNsPerOp = 0;
+    double maxNsPerOp = 0;
+    std::vector<std::pair<std::string,double>> extra;
+};
+
+// Scratch files for one run: a fresh directory under /tmp, removed with
+// everything file() named in it
+struct BenchTempDir {
+    std::string dir;
+    std::vector<std::string> files;
+
+    BenchTempDir() {
+        char tmpl[] = "/tmp/legionaura_bench_XXXXXX";
+        if (mkdtemp(tmpl)) dir = tmpl;
+    }
+    ~BenchTempDir() {
+        for (auto& f : files) std::remove(f.c_str());
+        if (!dir.empty()) ::rmdir(dir.c_str());
+    }
+    std::string file(const std::string& name) {
+        files.push_back(dir + "/" + name);
+        return files.back();
+    }
+};
+
+struct BenchOptions {
+    std::string filter;
+    double minTimeMs = 50;
+    int samples = 5;
+    LASimIte::Config sim;
+    std::string out;
+};
+
+// ------------------------------------------------------
+// Runs fn in batches sized so each sample lasts about minTimeMs/samples
+// ------------------------------------------------------
+static BenchResult measure(const std::string& name, const BenchOptions& o,
+                           const std::function<void()>& fn)
+{
+    using ns = std::chrono::duration<double, std::nano>;
+
+    uint64_t batch = 1;
+    const double target = o.minTimeMs * 1e6 / o.samples;
+    for (;;) {
+        auto t0 = Clock::now();
+        for (uint64_t k = 0; k < batch; ++k) fn();
+        double el = ns(Clock::now() - t0).count();
+        if (el >= target || batch >= (1ull << 30)) break;
+        batch = el < target / 100 ? batch * 10 : (uint64_t)(batch * target / std::max(el, 1.0)) + 1;
+    }
+
+    std::vector<double> perOp;
+    for (int s = 0; s < o.samples; ++s) {
+        auto t0 = Clock::now();
+        for (uint64_t k = 0; k < batch; ++k) fn();
+        perOp.push_back(ns(Clock::now() - t0).count() / batch);
+    }
+    std::sort(perOp.begin(), perOp.end());
+
+    BenchResult r;
+    r.name = name;
+    r.iterations = batch * o.samples;
+    r.nsPerOp = perOp[perOp.size() / 2];
+    r.minNsPerOp = perOp.front();
+    r.maxNsPerOp = perOp.back();
+    return r;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string o;
+    for (char c : s) {
+        if (c == '"' || c == '\\') o += '\\';
+        o += c;
+    }
+    return o;
+}
+
+static void writeJson(std::ostream& os, const BenchOptions& o, const std::vector<BenchResult>& rs) {
+    os.precision(10);
+    os << "{\n"
+       << "  \"version\": \"" << LEGIONAURA_VERSION << "\",\n"
+       << "  \"sim\": { \"latency_us\": " << o.sim.latencyUs
+       << ", \"fail_rate\": " << o.sim.failRate
+       << ", \"fail_every\": " << o.sim.failEvery << " },\n"
+       << "  \"results\": [\n";
+    for (size_t k = 0; k < rs.size(); ++k) {
+        const auto& r = rs[k];
+        os << "    { \"name\": \"" << jsonEscape(r.name) << "\""
+           << ", \"iterations\": " << r.iterations
+           << ", \"ns_per_op\": " << r.nsPerOp
+           << ", \"min_ns_per_op\": " << r.minNsPerOp
+           << ", \"max_ns_per_op\": " << r.maxNsPerOp;
+        for (auto& e : r.extra) os << ", \"" << jsonEscape(e.first) << "\": " << e.second;
+        os << " }" << (k + 1 < rs.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+static void usage(const char* prog){
+    std::cerr <<
+      "Usage:\n\n"
+      "  " << prog << " [--filter <substr>] [--min-time ms] [--samples N]\n"
+      "        [--latency-us N] [--fail-rate 0..1] [--fail-every N] [--out file.json]\n";
+}
+
+// ------------------------------------------------------
+// MAIN FUNCTION
+// ------------------------------------------------------
+int main(int argc, char** argv){
+    BenchOptions o;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) { usage(argv[0]); std::exit(1); }
+            return argv[++i];
+        };
+        if (a == "--filter") o.filter = next();
+        else if (a == "--min-time") o.minTimeMs = std::stod(next());
+        else if (a == "--samples") o.samples = std::max(1, std::stoi(next()));
+        else if (a == "--latency-us") o.sim.latencyUs = (unsigned)std::stoul(next());
+        else if (a == "--fail-rate") o.sim.failRate = std::stod(next());
+        else if (a == "--fail-every") o.sim.failEvery = std::stoull(next());
+        else if (a == "--out") o.out = next();
+        else if (a == "-h" || a == "--help") { usage(argv[0]); return 0; }
+        else { usage(argv[0]); return 1; }
+    }
+
+    std::vector<BenchResult> results;
+    auto run = [&](const std::string& name, const std::function<void()>& fn) -> BenchResult* {
+        if (!o.filter.empty() && name.find(o.filter) == std::string::npos) return nullptr;
+        results.push_back(measure(name, o, fn));
+        return &results.back();
+    };
+
+    // ----------------------------------------------------
+    // Pure functions
+    // ----------------------------------------------------
+    LAParams statik{LAEffect::Static, 1, 2,
+                    {LAColor{255,0,0}, LAColor{0,255,0}, LAColor{0,0,255}, LAColor{255,255,255}},
+                    LAWaveDir::None};
+    LAParams wave{LAEffect::Wave, 3, 1, {}, LAWaveDir::RTL};
+
+    run("buildPayload/static", [&]{ doNotOptimize(LegionAura::buildPayload(statik)); });
+    run("buildPayload/wave",   [&]{ doNotOptimize(LegionAura::buildPayload(wave)); });
+
+    const std::string hex = "A0b1C2";
+    run("parseHexRGB", [&]{ doNotOptimize(LegionAura::parseHexRGB(hex)); });
+
+    const std::vector<std::string> one{"FF0000"}, three{"FF0000", "00FF00", "0000FF"};
+    run("normalizeColors/1", [&]{ doNotOptimize(LegionAura::normalizeColors(one)); });
+    run("normalizeColors/3", [&]{ doNotOptimize(LegionAura::normalizeColors(three)); });
+
+    const std::string devicesJson = std::string(PROJECT_SOURCE_DIR) + "/devices/devices.json";
+    run("loadSupportedDevices", [&]{ doNotOptimize(LegionAura::loadSupportedDevices(devicesJson)); });
+
+    uint16_t probePid = 0xC955;
+    run("deviceLookup/builtin", [&]{
+        doNotOptimize(laFindBuiltinDevice(0x048D, probePid));
+        probePid = probePid == 0xC955 ? 0xC993 : 0xC955;
+    });
+
+    // Color stage: one frame of zones, and a batch of colors
+    LAColorProfile led;
+    led.gamma = 2.2f;
+    led.whiteBalance = {1.0f, 0.9f, 0.8f};
+    LAColorPipeline pipe(led, 40.0f);
+    run("color/apply/params", [&]{
+        LAParams q = statik;
+        pipe.apply(q);
+        doNotOptimize(q);
+    });
+    std::vector<LAColor> colors(1024, LAColor{200, 120, 40});
+    run("color/apply/batch1024", [&]{
+        pipe.apply(colors.data(), colors.data(), colors.size());
+        doNotOptimize(colors.front());
+    });
+    run("color/rebuildTables", [&, pct = 40.0f]() mutable {
+        pipe.setBrightness(pct = pct == 40.0f ? 41.0f : 40.0f);
+    });
+    LAIoRecorder rec;
+    run("ioStats/record", [&, us = uint64_t(1)]() mutable {
+        rec.record(LAIoOp::SetReport, 0, us = us * 3 % 4093);
+    });
+
+    run("color/oklab/roundtrip", [&, c = LAColor{200, 120, 40}]() mutable {
+        c = laFromOklab(laToOklab(c));
+        doNotOptimize(c);
+    });
+
+    // One 60 fps hop of 48 kHz audio through window + FFT + bands
+    LAAudioAnalyzer dsp(48000, 1024);
+    std::vector<float> hop(800);
+    for (size_t k = 0; k < hop.size(); ++k)
+        hop[k] = 0.5f * (float)std::sin(2.0 * M_PI * 440.0 * k / 48000.0);
+    run("audio/analyze", [&]{ doNotOptimize(dsp.process(hop.data(), hop.size())); });
+
+    // One 1080p screen frame reduced to 4 zones with each kernel
+    for (auto fmt : {LAPixelFormat::BGRA32, LAPixelFormat::RGB24}) {
+        LAAmbientReducer amb(1920, 1080, fmt);
+        std::vector<uint8_t> frame(amb.frameBytes());
+        for (size_t k = 0; k < frame.size(); ++k) frame[k] = (uint8_t)(k * 131 >> 3);
+        const std::string tag = fmt == LAPixelFormat::BGRA32 ? "bgra" : "rgb";
+
+        for (auto k : {LAAmbientKernel::Scalar, LAAmbientKernel::SSE2, LAAmbientKernel::AVX2}) {
+            if (!LAAmbientReducer::kernelAvailable(k)) continue;
+            LAAmbientOptions ao;
+            ao.kernel = k;
+            ao.yStep = 1;
+            amb.setOptions(ao);
+            run("ambient/avg/1080p/" + tag + "/" + LAAmbientReducer::kernelName(k),
+                [&]{ doNotOptimize(amb.reduce(frame.data())); });
+        }
+        amb.setOptions(LAAmbientOptions{});
+        run("ambient/avg/1080p/" + tag + "/default", [&]{ doNotOptimize(amb.reduce(frame.data())); });
+        LAAmbientOptions dom;
+        dom.mode = LAAmbientMode::Dominant;
+        dom.xStep = dom.yStep = 2;
+        amb.setOptions(dom);
+        run("ambient/dominant_step2/1080p/" + tag, [&]{ doNotOptimize(amb.reduce(frame.data())); });
+    }
+
+    // 4K BGRA is 33 MB a frame and the full read is memory bound; the
+    // default reads every 4th row
+    {
+        LAAmbientReducer amb(3840, 2160, LAPixelFormat::BGRA32);
+        std::vector<uint8_t> frame(amb.frameBytes());
+        for (size_t k = 0; k < frame.size(); ++k) frame[k] = (uint8_t)(k * 131 >> 3);
+        LAAmbientOptions full;
+        full.yStep = 1;
+        amb.setOptions(full);
+        run("ambient/avg/4k/bgra/full", [&]{ doNotOptimize(amb.reduce(frame.data())); });
+        amb.setOptions(LAAmbientOptions{});
+        run("ambient/avg/4k/bgra/default", [&]{ doNotOptimize(amb.reduce(frame.data())); });
+    }
+
+    // ----------------------------------------------------
+    // Every SIMD kernel must give exactly the scalar result, including
+    // row tails and padded rows. Exits non-zero if not.
+    // ----------------------------------------------------
+    bool ambientOk = true;
+    if (o.filter.empty() || std::string("ambient/kernels").find(o.filter) != std::string::npos) {
+        struct Shape { int w, h; size_t pad; };
+        uint32_t seed = 12345;
+        uint64_t frames = 0;
+        for (auto fmt : {LAPixelFormat::BGRA32, LAPixelFormat::RGB24}) {
+            for (Shape sh : {Shape{1920, 1080, 0}, Shape{1917, 7, 12}, Shape{37, 5, 3}, Shape{4, 1, 0}}) {
+                const size_t bpp = fmt == LAPixelFormat::RGB24 ? 3 : 4;
+                LAAmbientReducer amb(sh.w, sh.h, fmt, (size_t)sh.w * bpp + sh.pad);
+                std::vector<uint8_t> frame(amb.frameBytes());
+                for (auto& b : frame) b = (uint8_t)((seed = seed * 1103515245u + 12345u) >> 24);
+
+                LAAmbientOptions ao;
+                ao.kernel = LAAmbientKernel::Scalar;
+                ao.yStep = 1;
+                amb.setOptions(ao);
+                const LAZoneFrame want = amb.reduce(frame.data());
+                for (auto k : {LAAmbientKernel::SSE2, LAAmbientKernel::AVX2}) {
+                    if (!LAAmbientReducer::kernelAvailable(k)) continue;
+                    ao.kernel = k;
+                    amb.setOptions(ao);
+                    frames++;
+                    const LAZoneFrame got = amb.reduce(frame.data());
+                    bool same = true;
+                    for (int z = 0; z < 4; ++z)
+                        same = same && got[z].r == want[z].r && got[z].g == want[z].g && got[z].b == want[z].b;
+                    if (same) continue;
+                    ambientOk = false;
+                    std::cerr << "ambient/kernels: " << LAAmbientReducer::kernelName(k) << " differs from scalar on "
+                              << sh.w << "x" << sh.h << (bpp == 4 ? " bgra" : " rgb") << "\n";
+                }
+            }
+        }
+        BenchResult r;
+        r.name = "ambient/kernels/equal";
+        r.iterations = frames;
+        r.extra.push_back({"mismatch", ambientOk ? 0.0 : 1.0});
+        results.push_back(r);
+    }
+
+    // ----------------------------------------------------
+    // End to end against the simulated controller
+    // ----------------------------------------------------
+    auto simRun = [&](const std::string& name, const std::function<void(LegionAura&)>& fn) {
+        LegionAura kb;
+        auto sim = std::make_unique<LASimIte>(o.sim);
+        LASimIte* dev = sim.get();
+        kb.openWith(std::move(sim));
+
+        BenchResult* r = run(name, [&]{ fn(kb); });
+        if (!r) return;
+
+        LATxCounters tx = kb.txCounters();
+        uint64_t attempts = dev->setCount() + dev->getCount() + dev->failures();
+        r->extra.push_back({"device_transfers", (double)attempts});
+        r->extra.push_back({"device_failures", (double)dev->failures()});
+        r->extra.push_back({"packets_sent", (double)tx.sent});
+        r->extra.push_back({"packets_suppressed", (double)tx.suppressed});
+
+        LAMailboxCounters mb = kb.mailboxCounters();
+        if (mb.posted) {
+            kb.close();   // drain so written/busy are final
+            mb = kb.mailboxCounters();
+            r->extra.push_back({"coalesced", (double)mb.coalesced});
+            r->extra.push_back({"device_fps", mb.deviceFps()});
+        }
+
+        LALatencyHistogram set = kb.ioStats().op(LAIoOp::SetReport).all();
+        if (set.count) {
+            r->extra.push_back({"set_report_p50_us", set.percentileUs(0.50)});
+            r->extra.push_back({"set_report_p99_us", set.percentileUs(0.99)});
+        }
+    };
+
+    // Alternate between two states so every call reaches the device
+    simRun("apply/sim", [&, flip = false](LegionAura& kb) mutable {
+        doNotOptimize(kb.apply((flip = !flip) ? statik : wave));
+    });
+    simRun("apply_unchanged/sim", [&](LegionAura& kb){ doNotOptimize(kb.apply(statik)); });
+    // Saved profiles: lookup by name plus one pre-encoded transfer
+    LAProfileStore profiles("/dev/null");
+    profiles.put("work", laEncode(statik));
+    profiles.put("gaming", laEncode(wave));
+    simRun("profile/apply/sim", [&, flip = false](LegionAura& kb) mutable {
+        doNotOptimize(kb.applyEncoded(*profiles.find((flip = !flip) ? "work" : "gaming")));
+    });
+
+    // Brightness toggles against the shadow state: one transfer per call.
+    // The cold variant forgets it every time and pays a read as well.
+    simRun("update/sim", [&, level = uint8_t(1)](LegionAura& kb) mutable {
+        doNotOptimize(kb.setBrightnessOnly(level = 3 - level));
+    });
+    simRun("update_cold/sim", [&, level = uint8_t(1)](LegionAura& kb) mutable {
+        kb.invalidateShadow();
+        doNotOptimize(kb.setBrightnessOnly(level = 3 - level));
+    });
+    simRun("readState/sim", [&](LegionAura& kb){
+        LAParams st;
+        doNotOptimize(kb.readState(st));
+    });
+    // Producer posting as fast as it can; the device sets the pace
+    simRun("post/sim", [&, flip = false](LegionAura& kb) mutable {
+        doNotOptimize(kb.post((flip = !flip) ? statik : wave));
+    });
+
+    // ns_per_op should stay at the fade length; packets_sent shows how many
+    // steps the measured round trip allowed
+    LAParams blue = statik;
+    blue.zones.fill(LAColor{0, 0, 255});
+    simRun("transition100ms/sim", [&, flip = false](LegionAura& kb) mutable {
+        doNotOptimize(kb.transition((flip = !flip) ? blue : statik, std::chrono::milliseconds(100)));
+    });
+
+    // Daemon vs direct. The daemon serves a simulated controller from its
+    // own thread over a real socket; "session" keeps one connection, as a
+    // batch script or the GUI does, "oneshot" connects per call, as each
+    // CLI invocation does. direct_oneshot opens and closes the device per
+    // call, minus what the sim can't show: libusb_init, bus enumeration
+    // and the interface claim, which real hardware adds on top.
+    {
+        const std::string sock = "/tmp/legionaura_bench_" + std::to_string(::getpid()) + ".sock";
+        LegionAura served;
+        auto sim = std::make_unique<LASimIte>(o.sim);
+        LASimIte* dev = sim.get();
+        served.openWith(std::move(sim));
+        LAIpcServer server(served);
+        std::string err;
+        if (server.listen(sock, err)) {
+            std::atomic<bool> stop{false};
+            std::thread loop([&]{ while (!stop && server.serveOnce(20)) {} });
+
+            LAClient client;
+            if (client.connect(sock)) {
+                BenchResult* r = run("ipc/daemon_session/sim", [&, flip = false]() mutable {
+                    doNotOptimize(client.apply((flip = !flip) ? statik : wave));
+                });
+                if (r) r->extra.push_back({"device_transfers", (double)dev->setCount()});
+
+                // A second client's 60 s fade runs on the same loop; state
+                // reads in between should cost what they do without it.
+                // The final apply ends the fade and releases the fader.
+                LAClient fader;
+                if (fader.connect(sock) && client.apply(statik)) {
+                    std::thread fading([&]{ fader.transition(blue, LA_IPC_MAX_FADE_MS); });
+                    const uint64_t sets0 = dev->setCount();
+                    LAParams st;
+                    r = run("ipc/state_during_fade/sim", [&]{ doNotOptimize(client.requestedState(st)); });
+                    if (r) r->extra.push_back({"fade_frames", (double)(dev->setCount() - sets0)});
+                    client.apply(statik);
+                    fading.join();
+                }
+                client.close();
+            }
+            run("ipc/daemon_oneshot/sim", [&, flip = false]() mutable {
+                LAClient c;
+                doNotOptimize(c.connect(sock) && c.apply((flip = !flip) ? statik : wave));
+            });
+
+            stop = true;
+            loop.join();
+        } else {
+            std::cerr << err << "\n";
+        }
+    }
+    run("ipc/direct_oneshot/sim", [&, flip = false]() mutable {
+        LegionAura kb;
+        doNotOptimize(kb.openWith(std::make_unique<LASimIte>(o.sim)) &&
+                      kb.apply((flip = !flip) ? statik : wave));
+    });
+
+    // Compiled timelines: opening an hour at 30 fps (3.9 MB) should cost
+    // the same as a short one; playback is 100 frames 200 us apart
+    {
+        const LAPacket a = laEncode(statik), b = laEncode(blue);
+        BenchTempDir tmp;
+        const std::string hourPath = tmp.file("1h.latl");
+        const std::string shortPath = tmp.file("20ms.latl");
+        LATimelineBuilder hour, brief;
+        for (uint64_t k = 0; k < 3600 * 30; ++k) hour.add(k * 1000000 / 30, (k & 1) ? a : b);
+        for (uint64_t k = 0; k < 100; ++k) brief.add(k * 200, (k & 1) ? a : b);
+        std::string err;
+        if (hour.save(hourPath, err) && brief.save(shortPath, err)) {
+            run("timeline/open/1h", [&]{
+                LATimeline tl;
+                doNotOptimize(tl.open(hourPath, err));
+            });
+
+            LATimeline tl;
+            tl.open(shortPath, err);
+            LATimelinePlayer player(tl);
+            simRun("timeline/play20ms/sim", [&](LegionAura& kb){
+                doNotOptimize(player.run([&kb](const LAPacket& p){ return kb.sendPacket(p); }));
+            });
+        }
+    }
+
+    // Three simulated controllers in lockstep; skew is the spread of
+    // completion times per frame
+    {
+        LADeviceGroup group;
+        for (uint8_t k = 0; k < 3; ++k) {
+            auto kb = std::make_unique<LegionAura>();
+            kb->openWith(std::make_unique<LASimIte>(o.sim));
+            group.add(std::move(kb), LAUsbDevice{0, (uint8_t)(k + 1), 0x048D, 0xC993});
+        }
+        double skewSum = 0, skewMax = 0;
+        uint64_t frames = 0;
+        BenchResult* r = run("group3/sim", [&, flip = false]() mutable {
+            LAGroupFrame f = group.apply((flip = !flip) ? statik : wave);
+            skewSum += f.skewUs;
+            skewMax = std::max(skewMax, f.skewUs);
+            frames++;
+        });
+        if (r && frames) {
+            r->extra.push_back({"skew_mean_us", skewSum / frames});
+            r->extra.push_back({"skew_max_us", skewMax});
+            double lateMax = 0;
+            for (auto& d : group.stats()) lateMax = std::max(lateMax, d.startMaxUs);
+            r->extra.push_back({"wake_late_max_us", lateMax});
+        }
+    }
+
+    // ----------------------------------------------------
+    // hidraw transport over a fake sysfs/dev tree: discovery must skip
+    // foreign devices and the controller's other interfaces, and packets
+    // must round-trip through the ioctl framing. Exits non-zero if not.
+    // ----------------------------------------------------
+    bool hidrawOk = true;
+    if (o.filter.empty() || std::string("hidraw/fake").find(o.filter) != std::string::npos) {
+        LAFakeHidrawRoot fake;
+        const auto lighting = LAFakeHidrawRoot::lightingDescriptor();
+        const auto keys = LAFakeHidrawRoot::keyboardDescriptor();
+        hidrawOk = fake.addNode("hidraw0", 0x046D, 0xC077, keys) &&       // a mouse
+                   fake.addNode("hidraw1", 0x048D, 0xC993, keys) &&       // controller, key interface
+                   fake.addNode("hidraw10", 0x048D, 0xC993, lighting) &&
+                   fake.addNode("hidraw2", 0x048D, 0xC993, lighting);
+
+        const auto nodes = LAHidrawTransport::find(fake.root());
+        hidrawOk = hidrawOk && nodes.size() == 2 && nodes[0].name == "hidraw2" && nodes[1].name == "hidraw10";
+        if (!hidrawOk) std::cerr << "hidraw/fake: discovery found " << nodes.size() << " node(s)\n";
+
+        LegionAura kb;
+        std::unique_ptr<LAFakeHidraw> t;
+        LASimIte::Config cfg = o.sim;
+        cfg.failRate = 0;      // a checked round trip; injected failures
+        cfg.failEvery = 0;     // are measured by the */sim cases
+        if (hidrawOk) t = LAFakeHidraw::open(nodes[0].devnode, std::make_unique<LASimIte>(cfg));
+        LAFakeHidraw* dev = t.get();
+        hidrawOk = dev && kb.openWith(std::move(t));
+
+        LAParams st;
+        hidrawOk = hidrawOk && kb.apply(wave) && kb.apply(statik) && kb.readState(st) &&
+                   laEncode(st) == laEncode(statik) && dev->badFrames() == 0;
+        if (!hidrawOk) std::cerr << "hidraw/fake: apply/readState did not round-trip\n";
+
+        if (hidrawOk) {
+            BenchResult* r = run("hidraw/fake/apply", [&, flip = false]() mutable {
+                doNotOptimize(kb.apply((flip = !flip) ? statik : wave));
+            });
+            if (r) r->extra.push_back({"device_transfers", (double)dev->device().setCount()});
+        }
+    }
+
+    // ----------------------------------------------------
+    // Telemetry over a fake /proc + /sys tree: loads from counter deltas,
+    // the package sensor picked by label, and no frame sent while the
+    // quantized colors stay put. Exits non-zero if not.
+    // ----------------------------------------------------
+    bool telemetryOk = true;
+    if (o.filter.empty() || std::string("telemetry/fake").find(o.filter) != std::string::npos) {
+        LAFakeTelemetryRoot fake;
+        const auto avail = LATelemetry::available(fake.root());
+        for (const char* m : {"cpu", "cpu0", "cpu1", "pkg", "thermal:acpitz", "hwmon:coretemp"})
+            telemetryOk = telemetryOk && std::find(avail.begin(), avail.end(), m) != avail.end();
+
+        LATelemetry tel(fake.root());
+        const char* specs[4] = {"cpu0", "cpu", "pkg", "thermal:acpitz"};
+        for (int z = 0; z < 4; ++z) {
+            LATelemetryZone cfg;
+            LAMetricSpec::parse(specs[z], cfg.metric);
+            if (cfg.metric.isTemperature()) cfg.ramp = LAColorRamp::forTemp();
+            tel.setZone(z, cfg);
+        }
+        tel.setIntervalMs(1);
+        std::string err;
+        telemetryOk = telemetryOk && tel.open(err);
+
+        // cpu0 half busy, cpu1 fully busy over the interval
+        std::array<float,4> v{};
+        telemetryOk = telemetryOk && fake.setCpus({{50, 50}, {100, 0}}) &&
+                      fake.setPackageTemp(72000) && fake.setThermal(41500);
+        tel.sample(&v);
+        telemetryOk = telemetryOk && std::fabs(v[0] - 50.f) < 0.01f && std::fabs(v[1] - 75.f) < 0.01f &&
+                      v[2] == 72.0f && v[3] == 41.5f;
+        if (!telemetryOk)
+            std::cerr << "telemetry/fake: read " << v[0] << " " << v[1] << " " << v[2] << " " << v[3]
+                      << (err.empty() ? "" : " (" + err + ")") << "\n";
+
+        uint64_t sent = 0;
+        auto count = [&](const LAParams&){ sent++; return true; };
+        if (telemetryOk) {
+            LATelemetryStats ts = tel.run(count, 20);
+            telemetryOk = ts.samples == 20 && sent == 1;
+            if (telemetryOk && fake.setPackageTemp(90000)) telemetryOk = tel.run(count, 1).applies == 1;
+            if (!telemetryOk) std::cerr << "telemetry/fake: " << sent << " frames, expected 1 then 1 more\n";
+        }
+
+        if (telemetryOk) run("telemetry/fake/sample", [&]{ doNotOptimize(tel.sample()); });
+    }
+
+    // ----------------------------------------------------
+    // Key-reactive mode on a replayed recording: 60 presses 4 ms apart
+    // across all zones, through the full epoll loop into a simulated
+    // controller. Every press must be handled, p99 key->submit must stay
+    // under one 60 fps frame, and the fade must end on the base color.
+    // Exits non-zero if not.
+    // ----------------------------------------------------
+    bool reactiveOk = true;
+    if (o.filter.empty() || std::string("reactive/replay").find(o.filter) != std::string::npos) {
+        BenchTempDir tmp;
+        const std::string path = tmp.file("keys.ev");
+        const uint16_t codes[] = {KEY_A, KEY_H, KEY_P, KEY_KP5, KEY_SPACE, KEY_ENTER};
+        constexpr int kPresses = 60;
+        if (FILE* f = std::fopen(path.c_str(), "wb")) {
+            auto put = [f](long us, uint16_t type, uint16_t code, int32_t value) {
+                input_event ev{};
+                ev.input_event_sec = 1000 + us / 1000000;
+                ev.input_event_usec = us % 1000000;
+                ev.type = type; ev.code = code; ev.value = value;
+                std::fwrite(&ev, sizeof ev, 1, f);
+            };
+            for (int k = 0; k < kPresses; ++k) {
+                const long t = k * 4000L;
+                put(t, EV_KEY, codes[k % 6], 1);
+                put(t, EV_SYN, SYN_REPORT, 0);
+                put(t + 1500, EV_KEY, codes[k % 6], 0);
+                put(t + 1500, EV_SYN, SYN_REPORT, 0);
+            }
+            std::fclose(f);
+        }
+
+        LAKeyRenderer renderer(LAKeyEffect::Ripple);
+        renderer.setColors({LAColor{255,0,0}, LAColor{0,255,0}, LAColor{0,0,255}, LAColor{255,255,255}},
+                           LAColor{0,0,16});
+        LAKeyReactive reactive(renderer, LAKeyMap::laptop());
+        std::string err;
+        reactiveOk = reactive.openReplay(path, 1.0, err);
+
+        LegionAura kb;
+        kb.openWith(std::make_unique<LASimIte>(o.sim));
+        LAParams shown{};
+        LAKeyStats ks;
+        if (reactiveOk)
+            ks = reactive.run([&](const LAParams& p){ shown = p; return kb.apply(p); });
+
+        const bool settled = shown.zones[0].b == 16 && shown.zones[3].r == 0 && shown.zones[3].b == 16;
+        reactiveOk = reactiveOk && ks.presses == kPresses && ks.frames > kPresses && settled &&
+                     ks.latency.count == kPresses && ks.latency.percentileUs(0.99) < ks.frameIntervalUs;
+        if (!reactiveOk)
+            std::cerr << "reactive/replay: " << ks.presses << " presses, " << ks.frames << " frames, p99 "
+                      << ks.latency.percentileUs(0.99) << " us" << (settled ? "" : ", not settled")
+                      << (err.empty() ? "" : " (" + err + ")") << "\n";
+
+        BenchResult r;
+        r.name = "reactive/replay";
+        r.iterations = ks.presses;
+        r.nsPerOp = ks.latency.meanUs() * 1000;
+        r.minNsPerOp = ks.latency.percentileUs(0.0) * 1000;   // first bucket's bound
+        r.maxNsPerOp = ks.latency.maxUs * 1000.0;
+        r.extra = {{"key_submit_p50_us", ks.latency.percentileUs(0.50)},
+                   {"key_submit_p99_us", ks.latency.percentileUs(0.99)},
+                   {"frame_interval_us", ks.frameIntervalUs}, {"frames", (double)ks.frames},
+                   {"cpu_fraction", ks.cpuFraction}};
+        results.push_back(r);
+
+        for (int k = 0; k < 32; ++k) renderer.hit(k % 4, k * 0.004);
+        run("reactive/render32", [&, t = 0.1]() mutable { doNotOptimize(renderer.render(t += 1e-6)); });
+    }
+
+    // ----------------------------------------------------
+    // LAIoThread stress: producers hammer one I/O thread; every command
+    // must reach the device, in per-producer order. Exits non-zero if not.
+    // ----------------------------------------------------
+    bool stressOk = true;
+    if (o.filter.empty() || std::string("queue/stress").find(o.filter) != std::string::npos) {
+        constexpr int kProducers = 8, kPerProducer = 5000;
+
+        LegionAura kb;
+        LASimIte::Config cfg = o.sim;
+        cfg.keepLog = true;
+        auto sim = std::make_unique<LASimIte>(cfg);
+        LASimIte* dev = sim.get();
+        kb.openWith(std::move(sim));
+
+        std::atomic<uint64_t> failed{0};
+        auto t0 = Clock::now();
+        {
+            LAIoThread io(kb);
+            std::vector<std::thread> producers;
+            for (int pr = 0; pr < kProducers; ++pr) {
+                producers.emplace_back([&, pr] {
+                    std::vector<std::future<bool>> done;
+                    done.reserve(kPerProducer);
+                    LAParams q = statik;
+                    for (int k = 0; k < kPerProducer; ++k) {
+                        // (producer, sequence) in zone 1 makes every packet unique
+                        q.zones[0] = LAColor{(uint8_t)pr, (uint8_t)(k >> 8), (uint8_t)k};
+                        done.push_back(io.apply(q));
+                        if (k % 64 == 0) io.readState();
+                    }
+                    for (auto& f : done) if (!f.get()) failed++;
+                });
+            }
+            for (auto& t : producers) t.join();
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        std::vector<int> last(kProducers, -1);
+        uint64_t seen = 0, reordered = 0;
+        for (auto& pkt : dev->log()) {
+            int pr = pkt[5], k = pkt[6] << 8 | pkt[7];
+            if (pr >= kProducers) continue;
+            if (k <= last[pr]) reordered++;
+            last[pr] = k;
+            seen++;
+        }
+        const uint64_t total = (uint64_t)kProducers * kPerProducer;
+        const uint64_t lost = total - failed.load() - seen;
+        stressOk = lost == 0 && reordered == 0;
+
+        BenchResult r;
+        r.name = "queue/stress";
+        r.iterations = total;
+        r.nsPerOp = r.minNsPerOp = r.maxNsPerOp = sec * 1e9 / total;
+        r.extra = {{"producers", (double)kProducers}, {"commands_per_s", total / sec},
+                   {"failed", (double)failed.load()}, {"lost", (double)lost},
+                   {"reordered", (double)reordered}};
+        results.push_back(r);
+        if (!stressOk)
+            std::cerr << "queue/stress: " << lost << " lost, " << reordered << " reordered\n";
+    }
+
+    if (o.out.empty()) {
+        writeJson(std::cout, o, results);
+    } else {
+        std::ofstream f(o.out);
+        if (!f) { std::cerr << "Cannot write " << o.out << "\n"; return 2; }
+        writeJson(f, o, results);
+    }
+    if (!stressOk) return 5;
+    if (!hidrawOk) return 6;
+    if (!telemetryOk) return 7;
+    if (!reactiveOk) return 8;
+    return ambientOk ? 0 : 9;
+}
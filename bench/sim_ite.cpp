@@ -0,0 +1,66 @@
+// /LegionAura/bench/sim_ite.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "sim_ite.h"
+
+LASimIte::LASimIte(const Config& cfg) : cfg_(cfg), rng_(cfg.seed) {
+    // Power-on default of the firmware: static white, low brightness
+    state_ = {0xCC, 0x16, 0x01, 0x01, 0x01};
+    for (int i = 5; i < 17; ++i) state_[i] = 0xFF;
+}
+
+int LASimIte::transferBegin() {
+    if (cfg_.latencyUs)
+        std::this_thread::sleep_for(std::chrono::microseconds(cfg_.latencyUs));
+
+    uint64_t n = ++seq_;
+    bool fail = cfg_.failEvery && n % cfg_.failEvery == 0;
+    if (!fail && cfg_.failRate > 0) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        fail = std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < cfg_.failRate;
+    }
+    if (fail) {
+        failures_++;
+        return cfg_.failCode;
+    }
+    return 0;
+}
+
+int LASimIte::setReport(const uint8_t* data, uint16_t len, unsigned) {
+    if (int err = transferBegin()) return err;
+
+    // The firmware stalls on anything that is not a 0xCC/0x16 lighting report
+    if (len < 2 || len > state_.size() || data[0] != 0xCC || data[1] != 0x16)
+        return -9; // LIBUSB_ERROR_PIPE
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    std::memcpy(state_.data(), data, len);
+    if (cfg_.keepLog) log_.push_back(state_);
+    sets_++;
+    return len;
+}
+
+int LASimIte::getReport(uint8_t* data, uint16_t len, unsigned) {
+    if (int err = transferBegin()) return err;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint16_t n = std::min<uint16_t>(len, (uint16_t)state_.size());
+    std::memcpy(data, state_.data(), n);
+    if (len > n) std::memset(data + n, 0, len - n);
+    gets_++;
+    return n;
+}
+
+std::array<uint8_t,32> LASimIte::lastPayload() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return state_;
+}
+
+std::vector<std::array<uint8_t,32>> LASimIte::log() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return log_;
+}
@@ -0,0 +1,49 @@
+// LegionAura/bench/sim_ite.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "legionaura.h"
+
+// ------------------------------------------------------
+// In-process stand-in for the ITE 8295 keyboard controller.
+// Accepts the same 0xCC 0x16 feature report as the firmware, remembers
+// it, and hands it back on GET_REPORT. Transfer latency and failures
+// can be injected so the I/O paths can be measured without a keyboard.
+// ------------------------------------------------------
+class LASimIte : public LATransport {
+public:
+    struct Config {
+        unsigned latencyUs = 0;     // added to every transfer
+        double   failRate  = 0.0;   // probability a transfer fails
+        uint64_t failEvery = 0;     // additionally fail every Nth transfer (0 = never)
+        int      failCode  = -1;    // libusb error returned on failure (LIBUSB_ERROR_IO)
+        uint32_t seed      = 1;
+        bool     keepLog   = false; // remember every accepted SET_REPORT, see log()
+    };
+
+    LASimIte() : LASimIte(Config{}) {}
+    explicit LASimIte(const Config& cfg);
+
+    int setReport(const uint8_t* data, uint16_t len, unsigned timeoutMs) override;
+    int getReport(uint8_t* data, uint16_t len, unsigned timeoutMs) override;
+
+    std::array<uint8_t,32> lastPayload() const;
+    std::vector<std::array<uint8_t,32>> log() const;   // in arrival order
+    uint64_t setCount() const { return sets_.load(); }
+    uint64_t getCount() const { return gets_.load(); }
+    uint64_t failures() const { return failures_.load(); }
+
+private:
+    int transferBegin();   // applies latency, returns 0 or the injected error
+
+    Config cfg_;
+    mutable std::mutex mtx_;
+    std::mt19937 rng_;
+    std::array<uint8_t,32> state_{};
+    std::vector<std::array<uint8_t,32>> log_;
+    std::atomic<uint64_t> sets_{0}, gets_{0}, failures_{0}, seq_{0};
+};
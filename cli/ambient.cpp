@@ -0,0 +1,116 @@
+// /LegionAura/cli/ambient.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+
+#include "ambient.h"
+#include "commands.h"
+
+static volatile std::sig_atomic_t g_stopAmbient = 0;
+static void stopAmbient(int){ g_stopAmbient = 1; }
+
+static bool parseSize(const std::string& s, int& w, int& h) {
+    auto x = s.find('x');
+    if (x == std::string::npos) return false;
+    return parseIntArg(s.substr(0, x), 4, 16384, w) && parseIntArg(s.substr(x + 1), 1, 16384, h);
+}
+
+// ------------------------------------------------------
+// ambient [file|-] --size WxH [--format rgb|bgra] [--mode avg|dominant]
+//         [--step N] [--xstep N] [--ystep N] [--kernel auto|scalar|sse2|avx2]
+//         [--brightness 1|2]
+// ------------------------------------------------------
+int cmdAmbient(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    size_t i = 0;
+    std::string path = "-";
+    if (i < args.size() && (args[i] == "-" || args[i][0] != '-')) path = args[i++];
+
+    int width = 0, height = 0, brightness = 2;
+    LAPixelFormat fmt = LAPixelFormat::BGRA32;
+    LAAmbientOptions ao;
+    while (i < args.size()){
+        const std::string& f = args[i++];
+        if (f == "--size" && i<args.size()) {
+            if (!parseSize(args[i++], width, height)){ std::cerr << "size must be WxH\n"; return 2; }
+        }
+        else if (f == "--format" && i<args.size()) {
+            const std::string& v = args[i++];
+            if (v == "rgb" || v == "rgb24") fmt = LAPixelFormat::RGB24;
+            else if (v == "bgra" || v == "bgr0") fmt = LAPixelFormat::BGRA32;
+            else { std::cerr << "format must be rgb or bgra\n"; return 2; }
+        }
+        else if (f == "--mode" && i<args.size()) {
+            const std::string& v = args[i++];
+            if (v == "avg" || v == "average") ao.mode = LAAmbientMode::Average;
+            else if (v == "dominant") ao.mode = LAAmbientMode::Dominant;
+            else { std::cerr << "mode must be avg or dominant\n"; return 2; }
+        }
+        else if ((f == "--step" || f == "--xstep" || f == "--ystep") && i<args.size()) {
+            int n;
+            if (!parseIntArg(args[i++], 1, 64, n)){ std::cerr << "step must be 1..64\n"; return 2; }
+            if (f != "--ystep") ao.xStep = n;
+            if (f != "--xstep") ao.yStep = n;
+        }
+        else if (f == "--kernel" && i<args.size()) {
+            const std::string& v = args[i++];
+            if (v == "auto") ao.kernel = LAAmbientKernel::Auto;
+            else if (v == "scalar") ao.kernel = LAAmbientKernel::Scalar;
+            else if (v == "sse2") ao.kernel = LAAmbientKernel::SSE2;
+            else if (v == "avx2") ao.kernel = LAAmbientKernel::AVX2;
+            else { std::cerr << "kernel must be auto, scalar, sse2 or avx2\n"; return 2; }
+            if (!LAAmbientReducer::kernelAvailable(ao.kernel)){ std::cerr << v << " is not supported on this CPU\n"; return 2; }
+        }
+        else if (f == "--brightness" && i<args.size()) {
+            if (!parseIntArg(args[i++], 1, 2, brightness)){ std::cerr << "brightness must be 1 or 2\n"; return 2; }
+        }
+        else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+    }
+    if (!width){ std::cerr << "ambient requires --size WxH\n"; return 2; }
+
+    LAAmbientReducer reducer(width, height, fmt);
+    reducer.setOptions(ao);
+
+    LARawFrameReader in;
+    if (!in.open(path, reducer.frameBytes())){ std::cerr << "Cannot read frames from " << path << "\n"; return 2; }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    std::signal(SIGINT, stopAmbient);
+    std::signal(SIGTERM, stopAmbient);
+
+    LAParams p{LAEffect::Static, 1, (uint8_t)brightness, {}, LAWaveDir::None};
+    std::vector<uint8_t> frame;
+    uint64_t frames = 0, failures = 0;
+    double reduceSum = 0, reduceMax = 0;
+
+    while (!g_stopAmbient && in.next(frame)) {
+        auto t0 = std::chrono::steady_clock::now();
+        LAZoneFrame z = reducer.reduce(frame.data());
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        reduceSum += us;
+        reduceMax = std::max(reduceMax, us);
+        frames++;
+
+        // Frames can arrive faster than the controller takes them; only the newest matters
+        for (int k = 0; k < 4; ++k) p.zones[k] = z[k];
+        if (!kb.post(p)) failures++;
+    }
+
+    const bool mailbox = kb.postsToMailbox();
+    kb.close();   // flushes the last posted frame
+    LAMailboxCounters mb = kb.mailboxCounters();
+    failures += mb.failures;
+
+    std::cout << "frames:          " << frames << " (" << width << "x" << height << ", kernel "
+              << LAAmbientReducer::kernelName(reducer.kernel()) << ")\n"
+              << "reduce mean/max: " << (frames ? reduceSum / frames : 0) << " / " << reduceMax << " us\n";
+    if (mailbox)
+        std::cout << "written:         " << mb.written << " (" << mb.coalesced << " coalesced, device-limited "
+                  << mb.deviceFps() << " fps)\n";
+    std::cout << "send failures:   " << failures << "\n";
+    return failures ? 4 : 0;
+}
@@ -0,0 +1,83 @@
+// /LegionAura/cli/animate.cpp
+
+#include <csignal>
+#include <iostream>
+
+#include "animation.h"
+#include "commands.h"
+
+static LAAnimator* g_anim = nullptr;
+static void stopAnimation(int){ if (g_anim) g_anim->stop(); }
+
+// ------------------------------------------------------
+// animate <wave|pulse|gradient> <colors...> [--fps N] [--period sec]
+//         [--duration sec] [--brightness 1|2]
+// ------------------------------------------------------
+int cmdAnimate(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    if (args.empty()){ std::cerr << "animate requires wave|pulse|gradient\n"; return 2; }
+    const std::string& kind = args[0];
+
+    size_t i = 1;
+    std::vector<std::string> rawColors;
+    while (i < args.size() && args[i][0] != '-') rawColors.push_back(args[i++]);
+    if (rawColors.empty()){ std::cerr << "animate needs 1+ colors\n"; return 2; }
+
+    std::vector<LAColor> palette;
+    for (auto& s : rawColors) {
+        auto c = LegionAura::parseHexRGB(s);
+        if (!c){ std::cerr << "Invalid color: " << s << "\n"; return 2; }
+        palette.push_back(*c);
+    }
+
+    double fps = 30, period = 2, duration = 0;
+    int brightness = 2;
+    try {
+        while (i < args.size()){
+            const std::string& f = args[i++];
+            if (f == "--fps" && i<args.size()) fps = std::stod(args[i++]);
+            else if (f == "--period" && i<args.size()) period = std::stod(args[i++]);
+            else if (f == "--duration" && i<args.size()) duration = std::stod(args[i++]);
+            else if (f == "--brightness" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1, 2, brightness)){ std::cerr << "brightness must be 1 or 2\n"; return 2; }
+            }
+            else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number\n";
+        return 2;
+    }
+    if (period <= 0){ std::cerr << "period must be > 0\n"; return 2; }
+
+    LARenderFn render;
+    if (kind == "wave") render = LAAnimator::paletteWave(palette, period);
+    else if (kind == "pulse") {
+        auto norm = LegionAura::normalizeColors(rawColors);
+        LAZoneFrame zones;
+        for (int z = 0; z < 4; ++z) zones[z] = *LegionAura::parseHexRGB(norm[z]);
+        render = LAAnimator::pulse(zones, period);
+    }
+    else if (kind == "gradient")
+        render = LAAnimator::gradient(palette.front(), palette.back(), period);
+    else { std::cerr << "Invalid animation: " << kind << "\n"; return 2; }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    LAAnimator anim(render, fps);
+    anim.setBrightness((uint8_t)brightness);
+    g_anim = &anim;
+    std::signal(SIGINT, stopAnimation);
+    std::signal(SIGTERM, stopAnimation);
+
+    LAAnimStats st = anim.run([&kb](const LAParams& p){ return kb.apply(p); }, duration);
+    g_anim = nullptr;
+
+    std::cout << "frames sent:    " << st.framesSent << "\n"
+              << "frames dropped: " << st.framesDropped << "\n"
+              << "send failures:  " << st.sendFailures << "\n"
+              << "achieved fps:   " << st.achievedFps << " (target " << fps << ")\n"
+              << "jitter mean/max: " << st.jitterMeanUs << " / " << st.jitterMaxUs << " us\n"
+              << "send mean/max:  " << st.sendMeanUs << " / " << st.sendMaxUs << " us\n";
+    return st.sendFailures ? 4 : 0;
+}
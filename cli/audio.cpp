@@ -0,0 +1,109 @@
+// /LegionAura/cli/audio.cpp
+
+#include <csignal>
+#include <iostream>
+
+#include "audio.h"
+#include "commands.h"
+
+static LAAudioReactive* g_audio = nullptr;
+static void stopAudio(int){ if (g_audio) g_audio->stop(); }
+
+// ------------------------------------------------------
+// audio [file|-] [--rate Hz] [--channels N] [--format s16|f32]
+//       [--fps N] [--fft N] [--attack ms] [--decay ms]
+//       [--colors c1 c2 c3 c4] [--brightness 1|2] [--realtime]
+// --rate/--channels/--format describe headerless input only; WAV
+// headers are detected and override them.
+// ------------------------------------------------------
+int cmdAudio(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    size_t i = 0;
+    std::string path = "-";
+    if (i < args.size() && (args[i] == "-" || args[i][0] != '-')) path = args[i++];
+
+    LAPcmFormat raw;
+    double fps = 60, attack = 10, decay = 180;
+    int fft = 1024, brightness = 2, rate = (int)raw.sampleRate, channels = raw.channels;
+    bool realtime = false;
+    std::vector<std::string> rawColors;
+    try {
+        while (i < args.size()){
+            const std::string& f = args[i++];
+            if (f == "--rate" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1000, 384000, rate)){ std::cerr << "Invalid rate\n"; return 2; }
+            }
+            else if (f == "--channels" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1, 8, channels)){ std::cerr << "Invalid channel count\n"; return 2; }
+            }
+            else if (f == "--format" && i<args.size()) {
+                const std::string& v = args[i++];
+                if (v == "s16") raw.format = LASampleFormat::S16LE;
+                else if (v == "f32") raw.format = LASampleFormat::F32LE;
+                else { std::cerr << "format must be s16 or f32\n"; return 2; }
+            }
+            else if (f == "--fps" && i<args.size()) fps = std::stod(args[i++]);
+            else if (f == "--fft" && i<args.size()) {
+                if (!parseIntArg(args[i++], 64, 16384, fft) || (fft & (fft - 1))){
+                    std::cerr << "fft size must be a power of two (64..16384)\n"; return 2;
+                }
+            }
+            else if (f == "--attack" && i<args.size()) attack = std::stod(args[i++]);
+            else if (f == "--decay" && i<args.size()) decay = std::stod(args[i++]);
+            else if (f == "--brightness" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1, 2, brightness)){ std::cerr << "brightness must be 1 or 2\n"; return 2; }
+            }
+            else if (f == "--colors") {
+                while (i < args.size() && args[i][0] != '-') rawColors.push_back(args[i++]);
+            }
+            else if (f == "--realtime") realtime = true;
+            else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number\n";
+        return 2;
+    }
+    if (fps <= 0){ std::cerr << "fps must be > 0\n"; return 2; }
+    raw.sampleRate = (uint32_t)rate;
+    raw.channels = (uint16_t)channels;
+
+    LAZoneFrame colors{LAColor{255,0,0}, LAColor{255,160,0}, LAColor{0,255,60}, LAColor{0,120,255}};
+    if (!rawColors.empty()) {
+        for (auto& s : rawColors)
+            if (!LegionAura::parseHexRGB(s)){ std::cerr << "Invalid color: " << s << "\n"; return 2; }
+        auto norm = LegionAura::normalizeColors(rawColors);
+        for (int z = 0; z < 4; ++z) colors[z] = *LegionAura::parseHexRGB(norm[z]);
+    }
+
+    LAPcmReader in;
+    if (!in.open(path, raw)){ std::cerr << "Cannot read audio from " << path << "\n"; return 2; }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    LAAudioAnalyzer dsp(in.format().sampleRate, (size_t)fft);
+    dsp.setSmoothing((float)attack, (float)decay);
+
+    LAAudioReactive reactive(in, dsp);
+    reactive.setFps(fps);
+    reactive.setColors(colors);
+    reactive.setBrightness((uint8_t)brightness);
+    reactive.setRealtime(realtime);
+    g_audio = &reactive;
+    std::signal(SIGINT, stopAudio);
+    std::signal(SIGTERM, stopAudio);
+
+    LAAudioStats st = reactive.run([&kb](const LAParams& p){ return kb.apply(p); });
+    g_audio = nullptr;
+
+    std::cout << "audio:          " << st.audioSec << " s @ " << in.format().sampleRate << " Hz"
+              << (in.isWav() ? " (wav)" : " (raw)") << "\n"
+              << "frames sent:    " << st.frames << "\n"
+              << "send failures:  " << st.sendFailures << "\n"
+              << "dsp mean/max:   " << st.dspMeanUs << " / " << st.dspMaxUs << " us"
+              << " (" << st.cpuFraction * 100 << "% of audio time)\n"
+              << "block->sent mean/p99/max: " << st.latencyMeanUs << " / " << st.latencyP99Us
+              << " / " << st.latencyMaxUs << " us\n"
+              << "hop buffering:  " << 1000.0 / fps << " ms (oldest sample in a block)\n";
+    return st.sendFailures ? 4 : 0;
+}
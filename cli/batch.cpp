@@ -0,0 +1,148 @@
+// /LegionAura/cli/batch.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "commands.h"
+
+using Clock = std::chrono::steady_clock;
+
+// ------------------------------------------------------
+// batch [file|-] [--quiet]
+//
+// One command per line in the normal CLI syntax, executed over a single
+// session. Extra directives:
+//   sleep <ms>        pause
+//   at <ms>           wait until <ms> after the batch started
+//   @<ms> <command>   same as "at <ms>" followed by <command>
+//   # ...             comment
+// Lines are executed as they are read, so `-` works with live pipes.
+// ------------------------------------------------------
+
+struct BatchRecord {
+    size_t line;
+    std::string text;
+    bool ok;
+    double us;
+};
+
+std::vector<std::string> splitWords(const std::string& line) {
+    std::vector<std::string> w;
+    std::istringstream ss(line.substr(0, line.find('#')));
+    for (std::string t; ss >> t;) w.push_back(t);
+    return w;
+}
+
+int cmdBatch(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    std::string src = "-";
+    bool quiet = false;
+    for (auto& a : args) {
+        if (a == "--quiet" || a == "-q") quiet = true;
+        else src = a;
+    }
+
+    std::ifstream file;
+    if (src != "-") {
+        file.open(src);
+        if (!file) { std::cerr << "Cannot read " << src << "\n"; return 2; }
+    }
+    std::istream& in = (src == "-") ? std::cin : file;
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    std::vector<BatchRecord> records;
+    size_t lineNo = 0, parseErrors = 0;
+    const auto start = Clock::now();
+
+    auto waitUntilOffset = [&](const std::string& ms) -> bool {
+        int v;
+        if (!parseIntArg(ms, 0, 86400000, v)) return false;
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(v));
+        return true;
+    };
+
+    for (std::string line; std::getline(in, line);) {
+        ++lineNo;
+        auto words = splitWords(line);
+        if (words.empty()) continue;
+
+        if (words[0][0] == '@') {
+            if (!waitUntilOffset(words[0].substr(1))) {
+                std::cerr << "line " << lineNo << ": bad timestamp " << words[0] << "\n";
+                parseErrors++;
+                continue;
+            }
+            words.erase(words.begin());
+            if (words.empty()) continue;
+        }
+
+        if (words[0] == "sleep" || words[0] == "at") {
+            int ms;
+            bool ok = words.size() == 2 && (words[0] == "at"
+                    ? waitUntilOffset(words[1])
+                    : parseIntArg(words[1], 0, 86400000, ms));
+            if (!ok) {
+                std::cerr << "line " << lineNo << ": " << words[0] << " needs milliseconds\n";
+                parseErrors++;
+            } else if (words[0] == "sleep") {
+                std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+            }
+            continue;
+        }
+
+        std::string err;
+        auto c = parseLightingCommand(words, err);
+        if (!c) {
+            std::cerr << "line " << lineNo << ": " << (err.empty() ? "Unknown command: " + words[0] : err) << "\n";
+            parseErrors++;
+            continue;
+        }
+
+        auto t0 = Clock::now();
+        bool ok = runLightingCommand(kb, *c);
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+        std::string text = words[0];
+        for (size_t k = 1; k < words.size(); ++k) text += " " + words[k];
+        records.push_back(BatchRecord{lineNo, text, ok, us});
+    }
+
+    const double totalSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // ------------------------------------------------------
+    // REPORT
+    // ------------------------------------------------------
+    std::vector<double> lat;
+    size_t failed = 0;
+    double busyUs = 0;
+    for (auto& r : records) {
+        if (!quiet)
+            std::cout << "line " << r.line << ": " << (r.ok ? "OK  " : "FAIL") << " "
+                      << (long long)r.us << "us  " << r.text << "\n";
+        lat.push_back(r.us);
+        busyUs += r.us;
+        if (!r.ok) failed++;
+    }
+    std::sort(lat.begin(), lat.end());
+
+    std::cout << "commands: " << records.size() << " (" << failed << " failed, "
+              << parseErrors << " rejected) via " << kb.pathName() << "\n";
+    if (!lat.empty()) {
+        auto pct = [&](double q){ return (long long)lat[std::min(lat.size() - 1, (size_t)(q * lat.size()))]; };
+        std::cout << "latency us: min " << (long long)lat.front() << "  p50 " << pct(0.50)
+                  << "  p99 " << pct(0.99) << "  max " << (long long)lat.back()
+                  << "  mean " << (long long)(busyUs / lat.size()) << "\n"
+                  << "throughput: " << (busyUs > 0 ? records.size() / (busyUs / 1e6) : 0)
+                  << " cmd/s while sending, " << (totalSec > 0 ? records.size() / totalSec : 0)
+                  << " cmd/s overall (" << totalSec << " s)\n";
+    }
+
+    if (parseErrors) return 2;
+    return failed ? 4 : 0;
+}
@@ -0,0 +1,137 @@
+// /LegionAura/cli/command.cpp
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "commands.h"
+
+bool parseIntArg(const std::string& s, int lo, int hi, int& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    long v = std::strtol(s.c_str(), &end, 10);
+    if (!end || *end != '\0' || v < lo || v > hi) return false;
+    out = (int)v;
+    return true;
+}
+
+std::optional<CliCommand> parseLightingCommand(const std::vector<std::string>& args,
+                                               std::string& err)
+{
+    err.clear();
+    if (args.empty()) return std::nullopt;
+
+    std::string cmd = args[0];
+    std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+
+    CliCommand c;
+    size_t i = 1;
+    int v = 0;
+
+    // ------------------------------------------------------
+    // BRIGHTNESS ONLY MODE ( --brightness 2 )
+    // ------------------------------------------------------
+    if (cmd == "--brightness") {
+        if (args.size() < 2 || !parseIntArg(args[1], 1, 2, v)) {
+            err = "brightness must be 1 or 2";
+            return std::nullopt;
+        }
+        c.kind = CliCommand::Kind::Brightness;
+        c.level = (uint8_t)v;
+        return c;
+    }
+
+    auto takeFade = [&]() -> bool {
+        if (!parseIntArg(args[i++], 0, 60000, v)) { err = "fade must be 0..60000 ms"; return false; }
+        c.fadeMs = (uint32_t)v;
+        return true;
+    };
+
+    if (cmd == "off") {
+        c.kind = CliCommand::Kind::Off;
+        while (i < args.size()) {
+            const std::string& f = args[i++];
+            if (f == "--fade" && i < args.size()) {
+                if (!takeFade()) return std::nullopt;
+            } else {
+                err = "Unknown arg: " + f;
+                return std::nullopt;
+            }
+        }
+        return c;
+    }
+
+    LAParams& p = c.params;
+
+    auto takeColors = [&]() -> bool {
+        std::vector<std::string> raw;
+        while (i < args.size() && args[i][0] != '-') raw.push_back(args[i++]);
+        if (raw.empty()) { err = cmd + " needs at least 1 color"; return false; }
+
+        raw = LegionAura::normalizeColors(raw);
+        for (int z = 0; z < 4; ++z) {
+            auto col = LegionAura::parseHexRGB(raw[z]);
+            if (!col) { err = "Invalid color: " + raw[z]; return false; }
+            p.zones[z] = *col;
+        }
+        return true;
+    };
+
+    // ------------------------------------------------------
+    // COMMANDS
+    // ------------------------------------------------------
+    if (cmd == "static") {
+        p.effect = LAEffect::Static;
+        if (!takeColors()) return std::nullopt;
+
+    } else if (cmd == "breath") {
+        p.effect = LAEffect::Breath;
+        if (!takeColors()) return std::nullopt;
+
+    } else if (cmd == "wave") {
+        p.effect = LAEffect::Wave;
+        if (i >= args.size()) { err = "wave requires direction ltr|rtl"; return std::nullopt; }
+        const std::string& d = args[i++];
+        if (d == "ltr") p.waveDir = LAWaveDir::LTR;
+        else if (d == "rtl") p.waveDir = LAWaveDir::RTL;
+        else { err = "Invalid direction"; return std::nullopt; }
+
+    } else if (cmd == "hue") {
+        p.effect = LAEffect::Hue;
+
+    } else {
+        return std::nullopt;   // not a lighting command; err stays empty
+    }
+
+    // ------------------------------------------------------
+    // OPTIONAL FLAGS
+    // ------------------------------------------------------
+    while (i < args.size()) {
+        const std::string& f = args[i++];
+        if (f == "--speed" && i < args.size()) {
+            if (!parseIntArg(args[i++], 1, 4, v)) { err = "speed must be 1..4"; return std::nullopt; }
+            p.speed = (uint8_t)v;
+        } else if (f == "--brightness" && i < args.size()) {
+            if (!parseIntArg(args[i++], 1, 2, v)) { err = "brightness must be 1 or 2"; return std::nullopt; }
+            p.brightness = (uint8_t)v;
+        } else if (f == "--fade" && i < args.size()) {
+            if (!takeFade()) return std::nullopt;
+        } else {
+            err = "Unknown arg: " + f;
+            return std::nullopt;
+        }
+    }
+    return c;
+}
+
+bool runLightingCommand(CliSession& kb, const CliCommand& c) {
+    switch (c.kind) {
+        case CliCommand::Kind::Off:
+            // The off packet is Static black, so it can be faded to like any color
+            if (c.fadeMs) return kb.transition(LAParams{LAEffect::Static, 1, 1, {}, LAWaveDir::None}, c.fadeMs);
+            return kb.off();
+        case CliCommand::Kind::Brightness: return kb.setBrightnessOnly(c.level);
+        case CliCommand::Kind::Apply:      break;
+    }
+    return c.fadeMs ? kb.transition(c.params, c.fadeMs) : kb.apply(c.params);
+}
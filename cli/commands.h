@@ -0,0 +1,50 @@
+// LegionAura/cli/commands.h
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+#include "session.h"
+
+// Options that apply to every subcommand
+struct CliOptions {
+    bool allowDaemon = true;   // --direct clears it
+    bool timing = false;       // --timing
+    uint8_t level = 100;       // --level 0..100 (software brightness)
+    std::string device;        // --device bus:addr | all | hidraw
+};
+
+// ------------------------------------------------------
+// One lighting command in the classic CLI syntax:
+//   static|breath <colors...> [--speed N] [--brightness N]
+//   wave <ltr|rtl> ... | hue ... | off [--fade ms] | --brightness 1|2
+// Shared by the one-shot CLI and batch mode.
+// ------------------------------------------------------
+struct CliCommand {
+    enum class Kind { Apply, Off, Brightness } kind = Kind::Apply;
+    LAParams params{LAEffect::Static, 1, 1, {}, LAWaveDir::None};
+    uint8_t level = 1;         // Brightness only
+    uint32_t fadeMs = 0;       // --fade: Apply/Off go through LegionAura::transition
+};
+
+// args[0] is the command word. Returns nullopt and sets err on bad input;
+// err is left empty when args[0] is not a lighting command at all.
+std::optional<CliCommand> parseLightingCommand(const std::vector<std::string>& args,
+                                               std::string& err);
+bool runLightingCommand(CliSession& kb, const CliCommand& c);
+
+bool parseIntArg(const std::string& s, int lo, int hi, int& out);
+std::vector<std::string> splitWords(const std::string& line);   // whitespace, '#' starts a comment
+
+// Subcommands (args exclude the subcommand word itself)
+int cmdBatch(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdAnimate(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdAudio(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdAmbient(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdStats(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdDevices(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdCompile(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdPlay(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdProfile(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdTelemetry(const std::vector<std::string>& args, const CliOptions& opt);
+int cmdReactive(const std::vector<std::string>& args, const CliOptions& opt);
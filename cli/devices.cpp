@@ -0,0 +1,26 @@
+// /LegionAura/cli/devices.cpp
+
+#include <cstdio>
+#include <iostream>
+
+#include "commands.h"
+#include "device_table.h"
+
+// ------------------------------------------------------
+// devices: every supported controller on the bus, with the bus:addr
+// that --device takes
+// ------------------------------------------------------
+int cmdDevices(const std::vector<std::string>& args, const CliOptions&)
+{
+    if (!args.empty()) { std::cerr << "Unknown arg: " << args[0] << "\n"; return 2; }
+
+    auto list = LegionAura::listDevices();
+    if (list.empty()) { std::cerr << "No supported device found.\n"; return 3; }
+
+    for (const LAUsbDevice& d : list) {
+        const LADeviceInfo* info = LADeviceRegistry::instance().find(d.vid, d.pid);
+        std::printf("%-8s %04x:%04x  %s (%u)\n", d.id().c_str(), d.vid, d.pid,
+                    info ? info->name : "?", info ? info->year : 0u);
+    }
+    return 0;
+}
@@ -4,7 +4,9 @@
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include "legionaura.h"
+#include "commands.h"
 
 
 // Nivedck -- @2025
@@ -14,51 +16,80 @@
 #endif
 
 
-// ------------------------------------------------------
-// Normalize colors (1->4, 2->4, 3->4, >4->trim)
-// ------------------------------------------------------
-static std::vector<std::string> normalize_colors(const std::vector<std::string>& in) {
-    if (in.empty()) return in;
-    std::vector<std::string> out = in;
-
-    for (auto& s : out) {
-        std::transform(s.begin(), s.end(), s.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-    }
-
-    if (out.size() == 1) out = {out[0], out[0], out[0], out[0]};
-    else if (out.size() == 2) out = {out[0], out[1], out[1], out[1]};
-    else if (out.size() == 3) out = {out[0], out[1], out[2], out[2]};
-    else if (out.size() > 4) out.resize(4);
-
-    return out;
-}
-
 static void usage(const char* prog){
     std::cerr <<
       "Usage:\n\n"
-      "  " << prog << " static <colors...> [--brightness 1|2]\n"
-      "  " << prog << " breath <colors...> [--speed 1..4] [--brightness 1|2]\n"
+      "  " << prog << " static <colors...> [--brightness 1|2] [--fade ms]\n"
+      "  " << prog << " breath <colors...> [--speed 1..4] [--brightness 1|2] [--fade ms]\n"
       "  " << prog << " wave <ltr|rtl> [--speed 1..4] [--brightness 1|2]\n"
       "  " << prog << " hue [--speed 1..4] [--brightness 1|2]\n"
-      "  " << prog << " off\n"
-      "  " << prog << " --brightness 1|2        (brightness only)\n\n"
+      "  " << prog << " off [--fade ms]\n"
+      "  " << prog << " animate <wave|pulse|gradient> <colors...> [--fps N] [--period sec]\n"
+      "               [--duration sec] [--brightness 1|2]   (host-rendered frames)\n"
+      "  " << prog << " audio [file|-] [--rate Hz] [--channels N] [--format s16|f32] [--fps N]\n"
+      "               [--fft N] [--attack ms] [--decay ms] [--colors c1..c4] [--realtime]\n"
+      "               (4 zones follow bass..treble of a WAV or raw PCM stream)\n"
+      "  " << prog << " ambient [file|-] --size WxH [--format rgb|bgra] [--mode avg|dominant]\n"
+      "               [--step N] [--kernel auto|scalar|sse2|avx2]   (zones follow raw screen frames)\n"
+      "  " << prog << " telemetry [--zone 1..4 <metric>] [--ramp 1..4 <value:color,...>] [--interval ms]\n"
+      "               [--steps N] [--duration sec] [--list]   (zones show cpu load / temperatures)\n"
+      "  " << prog << " reactive [flash|ripple|decay] [--colors c1..c4] [--base color] [--decay ms]\n"
+      "               [--ripple ms] [--fps N] [--input dev]... [--map code:zone,...]\n"
+      "               [--record file] [--replay file [--speed X]]   (zones react to key presses)\n"
+      "  " << prog << " --brightness 1|2        (brightness only)\n"
+      "  " << prog << " batch [file|-] [--quiet] (many commands, one session)\n"
+      "  " << prog << " compile [file|-] -o out.latl [--fps N] [--loop]\n"
+      "               (keyframe script in batch syntax -> precompiled timeline)\n"
+      "  " << prog << " play <file.latl> [--loop]   (stream a compiled timeline)\n"
+      "  " << prog << " profile list | save <name> [command...] | apply <name> [--fade ms] | delete <name>\n"
+      "               (named presets stored pre-encoded; save without a command keeps the last lighting set)\n"
+      "  " << prog << " devices                 (supported controllers and their bus:addr)\n"
+      "  " << prog << " stats [--probe N] [--prom file] [--reset]\n"
+      "               (USB transfer latency/error histograms, from legionaurad if running)\n\n"
+      "Global options:\n"
+      "  --direct    talk to the keyboard over USB even if legionaurad is running\n"
+      "  --timing    print which path was used and how long the command took\n"
+      "  --level N   software brightness 0..100 (perceptual, finer than --brightness)\n"
+      "  --device bus:addr|all   one specific controller, or every one in lockstep\n"
+      "  --device hidraw         the kernel's /dev/hidrawN node instead of libusb\n\n"
       "Notes:\n"
       "  • Colors must be hex RRGGBB (example: ff0000)\n"
       "  • If only 1–3 colors are given, remaining zones are auto-filled\n"
-      "  • Brightness: 1 = low, 2 = high\n";
+      "  • Brightness: 1 = low, 2 = high\n"
+      "  • --fade blends from the current colors (perceptual, paced to the USB round trip)\n"
+      "  • batch reads one command per line; also: sleep <ms>, at <ms>, @<ms> <command>\n";
 }
 
 // ------------------------------------------------------
 // MAIN FUNCTION ---- Nivedck
 // ------------------------------------------------------
 int main(int argc, char** argv){
-    if (argc < 2){ usage(argv[0]); return 1; }
-
-
+    // Strip global options so the command parser below only sees its own args
+    CliOptions opt;
+    std::vector<std::string> args;
+    for (int r = 1; r < argc; ++r) {
+        std::string a = argv[r];
+        if (a == "--direct") opt.allowDaemon = false;
+        else if (a == "--timing") opt.timing = true;
+        else if (a == "--level" && r + 1 < argc) {
+            int v;
+            if (!parseIntArg(argv[++r], 0, 100, v)) { std::cerr << "level must be 0..100\n"; return 2; }
+            opt.level = (uint8_t)v;
+        }
+        else if (a == "--device" && r + 1 < argc) {
+            opt.device = argv[++r];
+            uint8_t bus, addr;
+            if (opt.device != "all" && opt.device != "hidraw" && !LAUsbDevice::parseId(opt.device, bus, addr)) {
+                std::cerr << "device must be bus:addr (see: legionaura devices), all or hidraw\n";
+                return 2;
+            }
+        }
+        else args.push_back(a);
+    }
 
+    if (args.empty()){ usage(argv[0]); return 1; }
 
-    std::string cmd = argv[1];
+    std::string cmd = args[0];
     std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
 
         // Help flags
@@ -73,138 +104,51 @@ int main(int argc, char** argv){
         return 0;
     }
 
-
-    uint8_t speed = 1, brightness = 1;
-    LAWaveDir wdir = LAWaveDir::None;
-    LAEffect eff = LAEffect::Static;
-    std::array<LAColor,4> zones {LAColor{0,0,0},LAColor{0,0,0},LAColor{0,0,0},LAColor{0,0,0}};
-
-    int i = 2;
-
-    // ------------------------------------------------------
-    // BRIGHTNESS ONLY MODE ( --brightness 2 )
-    // ------------------------------------------------------
-    if (cmd == "--brightness") {
-        if (argc < 3) {
-            std::cerr << "brightness requires 1 or 2\n";
-            return 2;
-        }
-
-        brightness = (uint8_t)std::stoi(argv[2]);
-        if (brightness < 1 || brightness > 2) {
-            std::cerr << "brightness must be 1 or 2\n";
-            return 2;
-        }
-
-        LegionAura kb;
-        if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
-        bool ok = kb.setBrightnessOnly(brightness);
-
-        std::cout << (ok ? "OK\n" : "FAIL\n");
-        return ok ? 0 : 4;
-    }
-
     // ------------------------------------------------------
-    // Helper lambdas
+    // SUBCOMMANDS WITH THEIR OWN SYNTAX
     // ------------------------------------------------------
-    std::vector<std::string> rawColors;
-
-    auto parseDynamicColors = [&](std::vector<std::string>& out){
-        while (i < argc && argv[i][0] != '-') {
-            out.push_back(argv[i]);
-            i++;
-        }
-    };
-
-    auto fillZones = [&](const std::vector<std::string>& cvec){
-        for (int z=0; z<4; ++z){
-            auto c = LegionAura::parseHexRGB(cvec[z]);
-            if (!c){
-                std::cerr << "Invalid color: " << cvec[z] << "\n";
-                exit(2);
-            }
-            zones[z] = *c;
-        }
-    };
-
-    // ------------------------------------------------------
-    // COMMANDS
-    // ------------------------------------------------------
-    if (cmd == "static") {
-        eff = LAEffect::Static;
-        parseDynamicColors(rawColors);
-        if (rawColors.empty()){ std::cerr << "static needs at least 1 color\n"; return 2; }
-        rawColors = normalize_colors(rawColors);
-        fillZones(rawColors);
-
-    } else if (cmd == "breath") {
-        eff = LAEffect::Breath;
-        parseDynamicColors(rawColors);
-        if (rawColors.empty()){ std::cerr << "breath needs 1+ colors\n"; return 2; }
-        rawColors = normalize_colors(rawColors);
-        fillZones(rawColors);
-
-    } else if (cmd == "wave") {
-        eff = LAEffect::Wave;
-        if (i >= argc){
-            std::cerr << "wave requires direction ltr|rtl\n";
-            return 2;
-        }
-        std::string d = argv[i++];
-        if (d == "ltr") wdir = LAWaveDir::LTR;
-        else if (d == "rtl") wdir = LAWaveDir::RTL;
-        else { std::cerr << "Invalid direction\n"; return 2; }
-
-    } else if (cmd == "hue") {
-        eff = LAEffect::Hue;
-
-    } else if (cmd == "off") {
-        LegionAura kb;
-        if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
-        bool ok = kb.off();
-        std::cout << (ok ? "OK\n" : "FAIL\n");
-        return ok ? 0 : 4;
-
-    } else {
-        usage(argv[0]);
-        return 1;
-    }
+    const std::vector<std::string> rest(args.begin() + 1, args.end());
+    if (cmd == "batch")   return cmdBatch(rest, opt);
+    if (cmd == "animate") return cmdAnimate(rest, opt);
+    if (cmd == "audio")   return cmdAudio(rest, opt);
+    if (cmd == "ambient") return cmdAmbient(rest, opt);
+    if (cmd == "stats")   return cmdStats(rest, opt);
+    if (cmd == "devices") return cmdDevices(rest, opt);
+    if (cmd == "compile") return cmdCompile(rest, opt);
+    if (cmd == "play")    return cmdPlay(rest, opt);
+    if (cmd == "profile") return cmdProfile(rest, opt);
+    if (cmd == "telemetry") return cmdTelemetry(rest, opt);
+    if (cmd == "reactive")  return cmdReactive(rest, opt);
 
     // ------------------------------------------------------
-    // OPTIONAL FLAGS
+    // ONE LIGHTING COMMAND
     // ------------------------------------------------------
-    while (i < argc){
-        std::string f = argv[i++];
-        if (f == "--speed" && i<argc) {
-            speed = (uint8_t)std::stoi(argv[i++]);
-            if (speed<1 || speed>4){
-                std::cerr << "speed must be 1..4\n";
-                return 2;
-            }
-        } else if (f == "--brightness" && i<argc) {
-            brightness = (uint8_t)std::stoi(argv[i++]);
-            if (brightness<1 || brightness>2){
-                std::cerr << "brightness must be 1 or 2\n";
-                return 2;
-            }
-        } else {
-            std::cerr << "Unknown arg: " << f << "\n";
-            return 2;
-        }
+    std::string err;
+    auto c = parseLightingCommand(args, err);
+    if (!c) {
+        if (err.empty()) { usage(argv[0]); return 1; }
+        std::cerr << err << "\n";
+        return 2;
     }
 
-    // ------------------------------------------------------
-    // APPLY FINAL PARAMETERS
-    // ------------------------------------------------------
-    LAParams p{eff, speed, brightness, zones, wdir};
+    auto t0 = std::chrono::steady_clock::now();
 
-    LegionAura kb;
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
     if (!kb.open()){
         std::cerr << "Device open failed.\n";
         return 3;
     }
 
-    bool ok = kb.apply(p);
+    bool ok = runLightingCommand(kb, *c);
     std::cout << (ok ? "OK\n" : "FAIL\n");
+    if (opt.timing) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "path=" << kb.pathName() << " time=" << us << "us\n";
+        if (LADeviceGroup* g = kb.group())
+            for (auto& d : g->stats())
+                std::cerr << "  " << d.device.id() << " done=+" << (long long)d.doneMaxUs
+                          << "us after the shared deadline" << (d.failures ? " FAILED" : "") << "\n";
+    }
     return ok ? 0 : 4;
-}
\ No newline at end of file
+}
@@ -0,0 +1,133 @@
+// /LegionAura/cli/profile.cpp
+
+#include <cstdio>
+#include <iostream>
+
+#include "commands.h"
+#include "packet.h"
+#include "profiles.h"
+
+// ------------------------------------------------------
+// profile list
+// profile save <name> [<command...>]
+// profile apply <name> [--fade ms]
+// profile delete <name>
+//
+// save takes a lighting command in the normal syntax (static ff0000
+// --brightness 2, wave ltr, off, ...); without one it stores the
+// lighting last set through LegionAura, as it was requested (before
+// color correction). apply is a lookup plus one transfer.
+// ------------------------------------------------------
+
+static void describe(const LAPacket& pkt) {
+    LAParams p;
+    if (!laDecode(pkt.data(), pkt.size(), p)) return;
+    switch (p.effect) {
+        case LAEffect::Static: std::cout << "static"; break;
+        case LAEffect::Breath: std::cout << "breath"; break;
+        case LAEffect::Wave:   std::cout << "wave " << (p.waveDir == LAWaveDir::RTL ? "rtl" : "ltr"); break;
+        case LAEffect::Hue:    std::cout << "hue"; break;
+        default:               std::cout << "?"; break;
+    }
+    if (p.effect == LAEffect::Static || p.effect == LAEffect::Breath) {
+        char hex[8];
+        for (auto& z : p.zones) {
+            std::snprintf(hex, sizeof(hex), " %02x%02x%02x", z.r, z.g, z.b);
+            std::cout << hex;
+        }
+    }
+    if (p.effect != LAEffect::Static) std::cout << " --speed " << (int)p.speed;
+    std::cout << " --brightness " << (int)p.brightness;
+}
+
+int cmdProfile(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    if (args.empty()) { std::cerr << "profile requires list|save|apply|delete\n"; return 2; }
+    const std::string& sub = args[0];
+
+    LAProfileStore store;
+    std::string err;
+    if (!store.load(err)) { std::cerr << err << "\n"; return 2; }
+
+    if (sub == "list") {
+        for (auto& name : store.names()) {
+            std::cout << name << "\t";
+            describe(*store.find(name));
+            std::cout << "\n";
+        }
+        return 0;
+    }
+
+    if (args.size() < 2) { std::cerr << "profile " << sub << " needs a name\n"; return 2; }
+    const std::string& name = args[1];
+
+    if (sub == "delete") {
+        if (!store.remove(name)) { std::cerr << "No profile named " << name << "\n"; return 2; }
+        if (!store.save(err)) { std::cerr << err << "\n"; return 2; }
+        return 0;
+    }
+
+    if (sub == "save") {
+        if (!LAProfileStore::validName(name)) {
+            std::cerr << "Profile names are 1.." << LA_PROFILE_NAME_MAX << " characters without spaces or '/'\n";
+            return 2;
+        }
+
+        LAPacket pkt;
+        if (args.size() > 2) {
+            const std::vector<std::string> words(args.begin() + 2, args.end());
+            auto c = parseLightingCommand(words, err);
+            if (!c) { std::cerr << (err.empty() ? "Unknown command: " + words[0] : err) << "\n"; return 2; }
+            if (c->kind == CliCommand::Kind::Brightness || c->fadeMs) {
+                std::cerr << "A profile is a full lighting state; --brightness alone and --fade can't be saved\n";
+                return 2;
+            }
+            pkt = c->kind == CliCommand::Kind::Off ? kLAPacketOff : laEncode(c->params);
+        } else {
+            // Colors as requested: what the device shows has been through
+            // the color pipeline, and applying it would correct it again
+            CliSession kb(opt.allowDaemon, opt.level, opt.device);
+            LAParams cur;
+            if (!kb.open()) { std::cerr << "Device open failed.\n"; return 3; }
+            if (!kb.requestedState(cur)) {
+                std::cerr << "The current lighting went through color correction (model profile or --level)\n"
+                             "and can't be saved as requested; give the command to save instead:\n"
+                             "  legionaura profile save " << name << " static ff0000\n";
+                return 3;
+            }
+            pkt = laEncode(cur);
+        }
+
+        store.put(name, pkt);
+        if (!store.save(err)) { std::cerr << err << "\n"; return 2; }
+        return 0;
+    }
+
+    if (sub == "apply") {
+        int fade = 0;
+        for (size_t i = 2; i < args.size(); ++i) {
+            if (args[i] == "--fade" && i + 1 < args.size()) {
+                if (!parseIntArg(args[++i], 0, 60000, fade)) { std::cerr << "fade must be 0..60000 ms\n"; return 2; }
+            } else { std::cerr << "Unknown arg: " << args[i] << "\n"; return 2; }
+        }
+
+        const LAPacket* pkt = store.find(name);
+        if (!pkt) { std::cerr << "No profile named " << name << " (see: legionaura profile list)\n"; return 2; }
+
+        CliSession kb(opt.allowDaemon, opt.level, opt.device);
+        if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+        bool ok;
+        if (fade) {
+            LAParams p;
+            ok = laDecode(pkt->data(), pkt->size(), p) && kb.transition(p, (uint32_t)fade);
+        } else {
+            ok = kb.applyEncoded(*pkt);
+        }
+        if (!ok) { std::cerr << "Failed to apply.\n"; return 4; }
+        return 0;
+    }
+
+    std::cerr << "Invalid profile command: " << sub << "\n";
+    return 2;
+}
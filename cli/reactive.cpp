@@ -0,0 +1,132 @@
+// /LegionAura/cli/reactive.cpp
+
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+
+#include "commands.h"
+#include "reactive.h"
+
+static LAKeyReactive* g_reactive = nullptr;
+static void stopReactive(int){ if (g_reactive) g_reactive->stop(); }
+
+// ------------------------------------------------------
+// reactive [flash|ripple|decay] [--colors c1..c4] [--base color]
+//          [--decay ms] [--ripple ms] [--fps N] [--brightness 1|2]
+//          [--input /dev/input/eventN]... [--map code:zone,...]
+//          [--record file] [--replay file [--speed X]]
+// Without --input every keyboard-like event device is used. --replay
+// plays a recorded input_event stream instead of live input (speed 0 =
+// back to back), so the mode can be measured without a keyboard.
+// ------------------------------------------------------
+int cmdReactive(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    size_t i = 0;
+    LAKeyEffect effect = LAKeyEffect::Ripple;
+    if (i < args.size() && args[i][0] != '-') {
+        const std::string& e = args[i++];
+        if (e == "flash") effect = LAKeyEffect::Flash;
+        else if (e == "ripple") effect = LAKeyEffect::Ripple;
+        else if (e == "decay") effect = LAKeyEffect::Decay;
+        else { std::cerr << "effect must be flash, ripple or decay\n"; return 2; }
+    }
+
+    double fps = 60, decay = 350, ripple = 60, speed = 1;
+    int brightness = 2;
+    std::vector<std::string> rawColors, inputs;
+    std::string base = "000000", map, recordPath, replayPath;
+    try {
+        while (i < args.size()){
+            const std::string& f = args[i++];
+            if (f == "--colors") {
+                while (i < args.size() && args[i][0] != '-') rawColors.push_back(args[i++]);
+            }
+            else if (f == "--base" && i<args.size()) base = args[i++];
+            else if (f == "--decay" && i<args.size()) decay = std::stod(args[i++]);
+            else if (f == "--ripple" && i<args.size()) ripple = std::stod(args[i++]);
+            else if (f == "--fps" && i<args.size()) fps = std::stod(args[i++]);
+            else if (f == "--speed" && i<args.size()) speed = std::stod(args[i++]);
+            else if (f == "--brightness" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1, 2, brightness)){ std::cerr << "brightness must be 1 or 2\n"; return 2; }
+            }
+            else if (f == "--input" && i<args.size()) inputs.push_back(args[i++]);
+            else if (f == "--map" && i<args.size()) map = args[i++];
+            else if (f == "--record" && i<args.size()) recordPath = args[i++];
+            else if (f == "--replay" && i<args.size()) replayPath = args[i++];
+            else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number\n";
+        return 2;
+    }
+    if (fps <= 0 || decay <= 0 || ripple < 0 || speed < 0){ std::cerr << "fps/decay must be > 0, ripple/speed >= 0\n"; return 2; }
+
+    LAZoneFrame colors{LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}};
+    if (!rawColors.empty()) {
+        for (auto& s : rawColors)
+            if (!LegionAura::parseHexRGB(s)){ std::cerr << "Invalid color: " << s << "\n"; return 2; }
+        auto norm = LegionAura::normalizeColors(rawColors);
+        for (int z = 0; z < 4; ++z) colors[z] = *LegionAura::parseHexRGB(norm[z]);
+    }
+    auto baseColor = LegionAura::parseHexRGB(base);
+    if (!baseColor){ std::cerr << "Invalid color: " << base << "\n"; return 2; }
+
+    LAKeyMap keys = LAKeyMap::laptop();
+    if (!map.empty() && !LAKeyMap::parseOverrides(map, keys)) {
+        std::cerr << "map must be keycode:zone pairs, e.g. 30:1,57:4 (zone 0 unmaps)\n";
+        return 2;
+    }
+
+    LAKeyRenderer renderer(effect);
+    renderer.setColors(colors, *baseColor);
+    renderer.setDecayMs(decay);
+    renderer.setRippleMs(ripple);
+
+    LAKeyReactive reactive(renderer, keys);
+    reactive.setFps(fps);
+    reactive.setBrightness((uint8_t)brightness);
+
+    std::string err;
+    if (!replayPath.empty()) {
+        if (!reactive.openReplay(replayPath, speed, err)){ std::cerr << err << "\n"; return 2; }
+    } else {
+        if (inputs.empty()) inputs = LAKeyReactive::findKeyboards();
+        if (inputs.empty()) {
+            std::cerr << "No readable keyboard under /dev/input (add yourself to the input group, "
+                         "run with sudo, or pass --input)\n";
+            return 2;
+        }
+        for (auto& path : inputs)
+            if (!reactive.addDevice(path, err)){ std::cerr << err << "\n"; return 2; }
+        if (!recordPath.empty() && !reactive.record(recordPath, err)){ std::cerr << err << "\n"; return 2; }
+    }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    g_reactive = &reactive;
+    std::signal(SIGINT, stopReactive);
+    std::signal(SIGTERM, stopReactive);
+
+    LAKeyStats st = reactive.run([&kb](const LAParams& p){ return kb.apply(p); });
+    g_reactive = nullptr;
+
+    const LALatencyHistogram& h = st.latency;
+    std::cout << "key presses:    " << st.presses << " (" << st.unmapped << " on unmapped keys)\n"
+              << "frames sent:    " << st.frames << "\n"
+              << "send failures:  " << st.sendFailures << "\n"
+              << "cpu:            " << st.cpuFraction * 100 << "% of one core\n";
+    std::printf("key->submit us: p50 %.0f  p99 %.0f  max %llu  mean %.0f  (frame interval %.0f)\n",
+                h.percentileUs(0.50), h.percentileUs(0.99), (unsigned long long)h.maxUs, h.meanUs(),
+                st.frameIntervalUs);
+    std::printf("send us:        p50 %.0f  p99 %.0f  max %llu\n",
+                st.send.percentileUs(0.50), st.send.percentileUs(0.99), (unsigned long long)st.send.maxUs);
+    // Buckets are powers of two, like `legionaura stats`
+    for (int b = 0; b < LA_LAT_BUCKETS; ++b) {
+        if (!h.buckets[b]) continue;
+        std::printf("  < %8llu us %8llu %s\n", (unsigned long long)LALatencyHistogram::bucketUpperUs(b),
+                    (unsigned long long)h.buckets[b],
+                    LALatencyHistogram::bucketUpperUs(b) > st.frameIntervalUs ? "(over a frame)" : "");
+    }
+    return st.sendFailures ? 4 : 0;
+}
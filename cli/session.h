@@ -0,0 +1,116 @@
+// LegionAura/cli/session.h
+#pragma once
+#include <chrono>
+#include <memory>
+#include <string>
+#include "legionaura.h"
+#include "device_group.h"
+#include "ipc.h"
+#include "packet.h"
+
+// ------------------------------------------------------
+// One lighting session for the CLI: talks to legionaurad when it is
+// running, otherwise opens the keyboard directly over USB. --device
+// bus:addr opens that controller directly; --device all drives every
+// controller on the bus in lockstep (see device_group.h); --device
+// hidraw goes through the kernel's hidraw node (see hidraw.h).
+// ------------------------------------------------------
+class CliSession {
+public:
+    // level: software brightness 0..100%, applied after the model's color correction
+    explicit CliSession(bool allowDaemon = true, uint8_t level = 100, std::string device = "")
+        : allowDaemon_(allowDaemon), level_(level), device_(std::move(device)) {}
+
+    bool open() {
+        if (device_ == "all") {
+            group_ = std::make_unique<LADeviceGroup>();
+            group_->setSoftwareBrightness(level_);
+            return group_->openAll() > 0;
+        }
+        if (device_ == "hidraw") {
+            kb_.setSoftwareBrightness(level_);
+            return kb_.openHidraw();
+        }
+        if (!device_.empty()) {
+            uint8_t bus, addr;
+            kb_.setSoftwareBrightness(level_);
+            return LAUsbDevice::parseId(device_, bus, addr) && kb_.openAt(bus, addr);
+        }
+
+        if (allowDaemon_ && client_.connect()) return true;
+        kb_.setSoftwareBrightness(level_);
+        // Same order as the GUI: any known model first, then the default PID
+        // (which prints the permission hints when nothing can be opened).
+        return kb_.autoDetect() || kb_.open();
+    }
+
+    bool viaDaemon() const { return client_.connected(); }
+    const char* pathName() const {
+        return group_ ? "group" : viaDaemon() ? "daemon" : device_ == "hidraw" ? "hidraw" : "direct";
+    }
+    LADeviceGroup* group() { return group_.get(); }
+
+    bool apply(const LAParams& p) {
+        if (group_) return group_->apply(p).ok;
+        return viaDaemon() ? client_.apply(p, level_) : kb_.apply(p);
+    }
+    bool transition(const LAParams& p, uint32_t fadeMs) {
+        if (group_) return group_->transition(p, std::chrono::milliseconds(fadeMs)).ok;
+        return viaDaemon() ? client_.transition(p, fadeMs, level_)
+                           : kb_.transition(p, std::chrono::milliseconds(fadeMs));
+    }
+    // Latest-wins for producers that can outrun the device. The daemon
+    // and group paths are synchronous, which already paces the producer.
+    bool post(const LAParams& p) {
+        if (group_) return group_->apply(p).ok;
+        return viaDaemon() ? client_.apply(p, level_) : kb_.post(p);
+    }
+    // post() only goes through the mailbox on a direct single-device
+    // session; the counters are all zero otherwise
+    bool postsToMailbox() const { return !group_ && !viaDaemon(); }
+    LAMailboxCounters mailboxCounters() const { return kb_.mailboxCounters(); }
+    void close() { client_.close(); kb_.close(); if (group_) group_->close(); }
+
+    bool off() {
+        if (group_) return group_->off().ok;
+        return viaDaemon() ? client_.off() : kb_.off();
+    }
+    bool setBrightnessOnly(uint8_t level) {
+        if (group_) return group_->setBrightnessOnly(level).ok;
+        return viaDaemon() ? client_.setBrightnessOnly(level) : kb_.setBrightnessOnly(level);
+    }
+    // Saved profiles and compiled timelines: each device applies its own
+    // color correction and the level
+    bool applyEncoded(const LAPacket& payload) {
+        if (group_) return group_->applyEncoded(payload).ok;
+        if (!viaDaemon()) return kb_.applyEncoded(payload);
+        LAParams p;
+        return laDecode(payload.data(), payload.size(), p) && client_.apply(p, level_);
+    }
+    // A group reports its first device
+    bool readState(LAParams& out) {
+        if (group_) return group_->size() && group_->at(0).readState(out);
+        return viaDaemon() ? client_.readState(out) : kb_.readState(out);
+    }
+    // Before color correction; see LegionAura::requestedState
+    bool requestedState(LAParams& out) {
+        if (group_) return group_->size() && group_->at(0).requestedState(out);
+        return viaDaemon() ? client_.requestedState(out) : kb_.requestedState(out);
+    }
+    // Direct sessions only see the transfers made by this process
+    bool stats(LAIpcStats& out, bool reset = false) {
+        if (viaDaemon()) return client_.stats(out, reset);
+        LegionAura& kb = group_ && group_->size() ? group_->at(0) : kb_;
+        out = LAIpcStats{kb.txCounters(), kb.ioStats()};
+        if (reset) kb.resetIoStats();
+        return true;
+    }
+
+private:
+    bool allowDaemon_;
+    uint8_t level_;
+    std::string device_;
+    LAClient client_;
+    LegionAura kb_;
+    std::unique_ptr<LADeviceGroup> group_;
+};
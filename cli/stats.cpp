@@ -0,0 +1,71 @@
+// /LegionAura/cli/stats.cpp
+
+#include <cstdio>
+#include <iostream>
+
+#include "commands.h"
+#include "io_stats.h"
+
+static void printOp(LAIoOp op, const LAIoOpStats& s) {
+    const LALatencyHistogram all = s.all();
+    std::printf("%-11s %8llu transfers, %llu errors, %llu timeouts\n", laIoOpName(op),
+                (unsigned long long)all.count, (unsigned long long)s.errors(),
+                (unsigned long long)s.count(LIBUSB_ERROR_TIMEOUT));
+    if (!all.count) return;
+
+    std::printf("  %-14s %8s %10s %10s %10s %10s\n", "result", "count", "p50 us", "p99 us", "max us", "mean us");
+    auto row = [](const char* name, const LALatencyHistogram& h) {
+        std::printf("  %-14s %8llu %10.0f %10.0f %10llu %10.0f\n", name, (unsigned long long)h.count,
+                    h.percentileUs(0.50), h.percentileUs(0.99), (unsigned long long)h.maxUs, h.meanUs());
+    };
+    row("all", all);
+    for (int r = 0; r < LA_IO_RESULTS; ++r)
+        if (s.byResult[r].count) row(laIoResultName(laIoResultCode(r)), s.byResult[r]);
+}
+
+// ------------------------------------------------------
+// stats [--probe N] [--prom file] [--reset]
+//
+// Control-transfer health. Through legionaurad these cover every
+// transfer since the daemon started (or the last --reset); a direct
+// session only sees its own, so --probe N issues N GET_REPORTs first.
+// Percentiles are bucket upper bounds (powers of two).
+// ------------------------------------------------------
+int cmdStats(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    int probes = 0;
+    std::string promPath;
+    bool reset = false;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& f = args[i];
+        if (f == "--probe" && i + 1 < args.size()) {
+            if (!parseIntArg(args[++i], 1, 100000, probes)) { std::cerr << "probe must be 1..100000\n"; return 2; }
+        }
+        else if (f == "--prom" && i + 1 < args.size()) promPath = args[++i];
+        else if (f == "--reset") reset = true;
+        else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+    }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    for (int k = 0; k < probes; ++k) {
+        LAParams st;
+        kb.readState(st);
+    }
+
+    LAIpcStats st;
+    if (!kb.stats(st, reset)) { std::cerr << "Failed to read stats.\n"; return 4; }
+
+    std::cout << "path=" << kb.pathName()
+              << (kb.viaDaemon() ? "" : " (this process only; run legionaurad to accumulate)") << "\n"
+              << "packets sent: " << st.tx.sent << ", suppressed as unchanged: " << st.tx.suppressed << "\n";
+    printOp(LAIoOp::SetReport, st.io.op(LAIoOp::SetReport));
+    printOp(LAIoOp::GetReport, st.io.op(LAIoOp::GetReport));
+
+    if (!promPath.empty() && !laWriteIoStatsPrometheus(promPath, st.io)) {
+        std::cerr << "Cannot write " << promPath << "\n";
+        return 4;
+    }
+    return 0;
+}
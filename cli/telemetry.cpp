@@ -0,0 +1,103 @@
+// /LegionAura/cli/telemetry.cpp
+
+#include <csignal>
+#include <iostream>
+
+#include "commands.h"
+#include "telemetry.h"
+
+static LATelemetry* g_telemetry = nullptr;
+static void stopTelemetry(int){ if (g_telemetry) g_telemetry->stop(); }
+
+// ------------------------------------------------------
+// telemetry [--zone N <metric>]... [--ramp N <value:color,...>]...
+//           [--interval ms] [--steps N] [--duration sec]
+//           [--brightness 1|2] [--root dir] [--list]
+// Metrics: cpu, cpuN, pkg, thermal:<n|type>, hwmon:<name> (see
+// telemetry.h). Default: zones 1-2 cpu load, zones 3-4 package
+// temperature. --root reads <dir>/proc and <dir>/sys instead.
+// ------------------------------------------------------
+int cmdTelemetry(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    std::string root;
+    int interval = 1000, steps = 32, brightness = 2;
+    double duration = 0;
+    bool list = false;
+    std::array<std::string,4> metrics{"cpu", "cpu", "pkg", "pkg"};
+    std::array<std::string,4> ramps;
+
+    try {
+        for (size_t i = 0; i < args.size();) {
+            const std::string& f = args[i++];
+            int zone;
+            if ((f == "--zone" || f == "--ramp") && i + 1 < args.size()) {
+                if (!parseIntArg(args[i++], 1, 4, zone)){ std::cerr << "zone must be 1..4\n"; return 2; }
+                (f == "--zone" ? metrics : ramps)[zone - 1] = args[i++];
+            }
+            else if (f == "--interval" && i<args.size()) {
+                if (!parseIntArg(args[i++], 10, 60000, interval)){ std::cerr << "interval must be 10..60000 ms\n"; return 2; }
+            }
+            else if (f == "--steps" && i<args.size()) {
+                if (!parseIntArg(args[i++], 2, 256, steps)){ std::cerr << "steps must be 2..256\n"; return 2; }
+            }
+            else if (f == "--brightness" && i<args.size()) {
+                if (!parseIntArg(args[i++], 1, 2, brightness)){ std::cerr << "brightness must be 1 or 2\n"; return 2; }
+            }
+            else if (f == "--duration" && i<args.size()) duration = std::stod(args[i++]);
+            else if (f == "--root" && i<args.size()) root = args[i++];
+            else if (f == "--list") list = true;
+            else { std::cerr << "Unknown arg: " << f << "\n"; return 2; }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number\n";
+        return 2;
+    }
+
+    if (list) {
+        for (auto& m : LATelemetry::available(root)) std::cout << m << "\n";
+        return 0;
+    }
+
+    LATelemetry tel(root);
+    for (int z = 0; z < 4; ++z) {
+        LATelemetryZone cfg;
+        if (!LAMetricSpec::parse(metrics[z], cfg.metric)) {
+            std::cerr << "Unknown metric: " << metrics[z] << " (see: legionaura telemetry --list)\n";
+            return 2;
+        }
+        if (!ramps[z].empty()) {
+            if (!LAColorRamp::parse(ramps[z], cfg.ramp)) {
+                std::cerr << "Invalid ramp: " << ramps[z] << " (value:RRGGBB,... with ascending values)\n";
+                return 2;
+            }
+        } else if (cfg.metric.isTemperature()) {
+            cfg.ramp = LAColorRamp::forTemp();
+        }
+        tel.setZone(z, cfg);
+    }
+    tel.setIntervalMs((unsigned)interval);
+    tel.setSteps((unsigned)steps);
+    tel.setBrightness((uint8_t)brightness);
+
+    std::string err;
+    if (!tel.open(err)){ std::cerr << err << "\n"; return 2; }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    g_telemetry = &tel;
+    std::signal(SIGINT, stopTelemetry);
+    std::signal(SIGTERM, stopTelemetry);
+
+    const uint64_t ticks = duration > 0 ? (uint64_t)(duration * 1000 / interval) + 1 : 0;
+    LATelemetryStats st = tel.run([&kb](const LAParams& p){ return kb.apply(p); }, ticks);
+    g_telemetry = nullptr;
+
+    std::cout << "samples:        " << st.samples << " in " << st.elapsedSec << " s"
+              << " (" << st.missedTicks << " ticks missed)\n"
+              << "frames sent:    " << st.applies << " (only when a zone changed color)\n"
+              << "send failures:  " << st.sendFailures << "\n"
+              << "sample mean/max: " << st.sampleMeanUs << " / " << st.sampleMaxUs << " us\n"
+              << "cpu:            " << st.cpuFraction * 100 << "% of one core\n";
+    return st.sendFailures ? 4 : 0;
+}
@@ -0,0 +1,191 @@
+// /LegionAura/cli/timeline.cpp
+
+#include <algorithm>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+#include "color.h"
+#include "commands.h"
+#include "packet.h"
+#include "timeline.h"
+
+// ------------------------------------------------------
+// compile [file|-] -o out.latl [--fps N] [--loop]
+//
+// Turns a keyframe script into a .latl timeline (see timeline.h). The
+// script uses the batch syntax:
+//   @<ms> <command>   keyframe at <ms> after the start
+//   <command>         keyframe at the current time
+//   at <ms>           move the current time to <ms>
+//   sleep <ms>        move it forward by <ms>
+//   end <ms>          total length: hold the last frame until <ms>
+//   loop              repeat when played
+// Commands are the normal lighting commands. A --fade is rendered here
+// into OKLab-interpolated Static frames at --fps (default 30) and moves
+// the current time to its end. Colors are stored as requested; play
+// applies the model's color correction and --level.
+// ------------------------------------------------------
+
+int cmdCompile(const std::vector<std::string>& args, const CliOptions&)
+{
+    std::string src = "-", out;
+    int fps = 30;
+    bool loop = false;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& a = args[i];
+        if (a == "-o" && i + 1 < args.size()) out = args[++i];
+        else if (a == "--fps" && i + 1 < args.size()) {
+            if (!parseIntArg(args[++i], 1, 200, fps)) { std::cerr << "fps must be 1..200\n"; return 2; }
+        }
+        else if (a == "--loop") loop = true;
+        else if (a.size() > 1 && a[0] == '-') { std::cerr << "Unknown arg: " << a << "\n"; return 2; }
+        else src = a;
+    }
+    if (out.empty()) { std::cerr << "compile needs -o <file.latl>\n"; return 2; }
+
+    std::ifstream file;
+    if (src != "-") {
+        file.open(src);
+        if (!file) { std::cerr << "Cannot read " << src << "\n"; return 2; }
+    }
+    std::istream& in = (src == "-") ? std::cin : file;
+
+    LATimelineBuilder tl;
+    tl.setLoop(loop);
+
+    std::optional<LAParams> cur;    // state after the last keyframe
+    uint64_t nowUs = 0;
+    size_t lineNo = 0, errors = 0;
+
+    auto fail = [&](const std::string& msg) {
+        std::cerr << "line " << lineNo << ": " << msg << "\n";
+        errors++;
+    };
+    auto parseMs = [](const std::string& s, uint64_t& us) {
+        int v;
+        if (!parseIntArg(s, 0, 86400000, v)) return false;
+        us = (uint64_t)v * 1000;
+        return true;
+    };
+    auto emit = [&](uint64_t atUs, const LAParams& p) {
+        if (!tl.add(atUs, laEncode(p))) fail("keyframe overlaps the previous one");
+    };
+
+    for (std::string line; std::getline(in, line);) {
+        ++lineNo;
+        auto words = splitWords(line);
+        if (words.empty()) continue;
+
+        if (words[0][0] == '@') {
+            uint64_t at;
+            if (!parseMs(words[0].substr(1), at)) { fail("bad timestamp " + words[0]); continue; }
+            if (at < nowUs) { fail("keyframe overlaps the previous one"); continue; }
+            nowUs = at;
+            words.erase(words.begin());
+            if (words.empty()) continue;
+        }
+
+        if (words[0] == "loop" && words.size() == 1) { tl.setLoop(loop = true); continue; }
+        if (words[0] == "at" || words[0] == "sleep" || words[0] == "end") {
+            uint64_t ms;
+            if (words.size() != 2 || !parseMs(words[1], ms)) { fail(words[0] + " needs milliseconds"); continue; }
+            if (words[0] == "sleep") nowUs += ms;
+            else if (ms < nowUs) fail(words[0] + " is before the current time");
+            else if (words[0] == "at") nowUs = ms;
+            else tl.end(ms);
+            continue;
+        }
+
+        std::string err;
+        auto c = parseLightingCommand(words, err);
+        if (!c) { fail(err.empty() ? "Unknown command: " + words[0] : err); continue; }
+
+        LAParams target = c->params;
+        switch (c->kind) {
+            case CliCommand::Kind::Apply:
+                break;
+            case CliCommand::Kind::Off:
+                laDecode(kLAPacketOff.data(), kLAPacketOff.size(), target);
+                break;
+            case CliCommand::Kind::Brightness:
+                if (!cur) { fail("--brightness needs an earlier keyframe to change"); continue; }
+                target = *cur;
+                target.brightness = c->level;
+                break;
+        }
+
+        // Same rendering as LegionAura::transition, at a fixed rate
+        const uint64_t fadeUs = (uint64_t)c->fadeMs * 1000;
+        if (fadeUs && cur && LAZoneFade::canFade(cur->effect) && LAZoneFade::canFade(target.effect)) {
+            const LAZoneFade fade(*cur, target);
+            for (uint64_t k = 1;; ++k) {
+                const uint64_t t = k * 1000000 / (uint64_t)fps;
+                if (t >= fadeUs) break;
+                emit(nowUs + t, fade.at((float)t / (float)fadeUs));
+            }
+            nowUs += fadeUs;
+        }
+        emit(nowUs, target);
+        cur = target;
+    }
+
+    if (errors) return 2;
+    if (!tl.frames()) { std::cerr << "no keyframes\n"; return 2; }
+
+    std::string err;
+    if (!tl.save(out, err)) { std::cerr << err << "\n"; return 2; }
+
+    std::cout << out << ": " << tl.frames() << " frames, "
+              << (double)tl.durationUs() / 1e6 << " s"
+              << (loop ? ", loops" : "") << "\n";
+    return 0;
+}
+
+// ------------------------------------------------------
+// play <file.latl> [--loop]
+//
+// Streams a compiled timeline. The file is mapped and each packet goes
+// out through applyEncoded, so every path (direct, hidraw, group,
+// daemon) applies the model's color correction and --level the same
+// way; Ctrl+C stops and prints timing statistics.
+// ------------------------------------------------------
+
+static LATimelinePlayer* g_player = nullptr;
+static void stopPlayback(int){ if (g_player) g_player->stop(); }
+
+int cmdPlay(const std::vector<std::string>& args, const CliOptions& opt)
+{
+    std::string path;
+    bool loop = false;
+    for (auto& a : args) {
+        if (a == "--loop") loop = true;
+        else if (a.size() > 1 && a[0] == '-') { std::cerr << "Unknown arg: " << a << "\n"; return 2; }
+        else path = a;
+    }
+    if (path.empty()) { std::cerr << "play needs a .latl file (see: legionaura compile)\n"; return 2; }
+
+    LATimeline tl;
+    std::string err;
+    if (!tl.open(path, err)) { std::cerr << err << "\n"; return 2; }
+
+    CliSession kb(opt.allowDaemon, opt.level, opt.device);
+    if (!kb.open()){ std::cerr << "Device open failed.\n"; return 3; }
+
+    LATimelinePlayer player(tl);
+    g_player = &player;
+    std::signal(SIGINT, stopPlayback);
+    std::signal(SIGTERM, stopPlayback);
+
+    LAPlayStats st = player.run([&kb](const LAPacket& p){ return kb.applyEncoded(p); }, loop);
+    g_player = nullptr;
+
+    std::cout << "frames sent:    " << st.framesSent << " (" << tl.frameCount()
+              << " per pass) via " << kb.pathName() << "\n"
+              << "frames dropped: " << st.framesDropped << "\n"
+              << "send failures:  " << st.sendFailures << "\n"
+              << "passes:         " << st.loops << " (" << st.elapsedSec << " s)\n"
+              << "late mean/max:  " << st.lateMeanUs << " / " << st.lateMaxUs << " us\n";
+    return st.sendFailures ? 4 : 0;
+}
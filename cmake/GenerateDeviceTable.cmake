@@ -0,0 +1,59 @@
+# ------------------------------------------------------
+# devices/devices.json -> constexpr device table header
+#
+#   cmake -DIN=devices.json -DOUT=la_devices_generated.h -P GenerateDeviceTable.cmake
+# ------------------------------------------------------
+cmake_minimum_required(VERSION 3.19)
+
+file(READ "${IN}" json)
+
+string(JSON vendor GET "${json}" vendor)
+string(JSON count LENGTH "${json}" models)
+
+set(rows "")
+math(EXPR last "${count} - 1")
+foreach(i RANGE ${last})
+    string(JSON name GET "${json}" models ${i} name)
+    string(JSON year GET "${json}" models ${i} year)
+    string(JSON pid  GET "${json}" models ${i} pid)
+
+    # Per-model "vid" is optional and falls back to the file-wide vendor
+    string(JSON vid ERROR_VARIABLE noVid GET "${json}" models ${i} vid)
+    if (noVid)
+        set(vid "${vendor}")
+    endif()
+
+    # Optional color correction: "gamma": 2.2, "whiteBalance": [1.0, 0.9, 0.8]
+    string(JSON gamma ERROR_VARIABLE noGamma GET "${json}" models ${i} gamma)
+    if (noGamma)
+        set(gamma "1.0")
+    endif()
+    set(wb "")
+    foreach(ch 0 1 2)
+        string(JSON g ERROR_VARIABLE noWb GET "${json}" models ${i} whiteBalance ${ch})
+        if (noWb)
+            set(g "1.0")
+        endif()
+        list(APPEND wb "${g}")
+    endforeach()
+    list(JOIN wb ", " wb)
+
+    string(REPLACE "\"" "\\\"" name "${name}")
+    string(APPEND rows "    { ${vid}, ${pid}, ${year}, \"${name}\", ${gamma}, {${wb}} },\n")
+endforeach()
+
+set(content
+"// Generated from devices/devices.json by cmake/GenerateDeviceTable.cmake. Do not edit.
+#pragma once
+
+inline constexpr LADeviceInfo kLABuiltinDevices[] = {
+${rows}};
+")
+
+# Only touch the file when it changes so dependents do not rebuild needlessly
+if (EXISTS "${OUT}")
+    file(READ "${OUT}" old)
+endif()
+if (NOT "${old}" STREQUAL "${content}")
+    file(WRITE "${OUT}" "${content}")
+endif()
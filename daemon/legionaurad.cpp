@@ -0,0 +1,129 @@
+//LegionAura/daemon/legionaurad.cpp
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <csignal>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "legionaura.h"
+#include "ipc.h"
+
+#ifndef LEGIONAURA_VERSION
+#define LEGIONAURA_VERSION "unknown"
+#endif
+
+// Keeps the keyboard open and claimed for the lifetime of the process so
+// clients only pay for one round trip over a local socket per command.
+
+static volatile sig_atomic_t g_stop = 0;
+static void onSignal(int){ g_stop = 1; }
+
+static void usage(const char* prog){
+    std::cerr <<
+      "Usage:\n\n"
+      "  " << prog << " [--socket <path>] [--metrics <file.prom>] [--metrics-interval sec]\n\n"
+      "Notes:\n"
+      "  • Default socket: /run/legionaura/legionaura.sock as root,\n"
+      "    else $XDG_RUNTIME_DIR/legionaura.sock ($LEGIONAURA_SOCKET overrides both)\n"
+      "  • The legionaura CLI uses the daemon automatically when it is running\n"
+      "  • --metrics writes USB I/O stats in Prometheus text format (default every 15 s),\n"
+      "    e.g. into node_exporter's textfile collector directory\n";
+}
+
+// ------------------------------------------------------
+// MAIN FUNCTION
+// ------------------------------------------------------
+int main(int argc, char** argv){
+    std::string sockPath = laSocketPath();
+    std::string metricsPath;
+    int metricsSec = 15;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--socket" && i + 1 < argc) sockPath = argv[++i];
+        else if (a == "--metrics" && i + 1 < argc) metricsPath = argv[++i];
+        else if (a == "--metrics-interval" && i + 1 < argc) {
+            metricsSec = std::atoi(argv[++i]);
+            if (metricsSec < 1) { usage(argv[0]); return 1; }
+        }
+        else if (a == "-h" || a == "--help") { usage(argv[0]); return 0; }
+        else if (a == "-v" || a == "--version") {
+            std::cout << "legionaurad " << LEGIONAURA_VERSION << "\n";
+            return 0;
+        }
+        else { usage(argv[0]); return 1; }
+    }
+    if (sockPath.empty()) {
+        std::cerr << "legionaurad: XDG_RUNTIME_DIR is not set; pass --socket <path>\n";
+        return 1;
+    }
+
+    // Long-lived: start from what the keyboard shows so the first
+    // re-apply of the current profile is already deduplicated.
+    LegionAura kb;
+    kb.setSeedShadowOnOpen(true);
+    if (!kb.autoDetect() && !kb.open()) {
+        std::cerr << "Device open failed.\n";
+        return 3;
+    }
+
+    kb.enableHotplug([](bool connected) {
+        std::cerr << (connected ? "legionaurad: device reconnected, lighting restored\n"
+                                : "legionaurad: device disconnected, waiting for it to return\n");
+    });
+
+    LAIpcServer server(kb);
+    std::string err;
+    if (!server.listen(sockPath, err)) {
+        std::cerr << err << "\n";
+        return 5;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "legionaurad: listening on " << sockPath << "\n";
+
+    char vidpid[32];
+    std::snprintf(vidpid, sizeof(vidpid), "device=\"%04x:%04x\"", kb.getVid(), kb.getPid());
+    auto writeMetrics = [&]{
+        if (!metricsPath.empty() && !laWriteIoStatsPrometheus(metricsPath, kb.ioStats(), vidpid))
+            std::cerr << "legionaurad: cannot write " << metricsPath << "\n";
+    };
+    writeMetrics();
+    auto nextMetrics = std::chrono::steady_clock::now() + std::chrono::seconds(metricsSec);
+
+    // Clients are served in turn; each keeps its connection for as many
+    // commands as it likes (one-shot CLI calls, batch scripts, ...).
+    while (!g_stop) {
+        int timeoutMs = -1;
+        if (!metricsPath.empty()) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            nextMetrics - std::chrono::steady_clock::now()).count();
+            timeoutMs = (int)std::max<long long>(0, left);
+        }
+
+        if (!server.serveOnce(timeoutMs)) {
+            std::perror("poll");
+            break;
+        }
+
+        if (!metricsPath.empty() && std::chrono::steady_clock::now() >= nextMetrics) {
+            writeMetrics();
+            nextMetrics += std::chrono::seconds(metricsSec);
+        }
+    }
+
+    server.close();
+    writeMetrics();
+
+    LATxCounters tx = kb.txCounters();
+    std::cerr << "legionaurad: " << tx.sent << " packets sent, "
+              << tx.suppressed << " suppressed as unchanged\n";
+    return 0;
+}
@@ -0,0 +1,114 @@
+// /LegionAura/gui/DeviceWorker.cpp
+#include "DeviceWorker.h"
+
+#include <algorithm>
+#include <chrono>
+
+DeviceWorker::DeviceWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DeviceWorker::~DeviceWorker() = default;
+
+// ------------------------------------------------------------------
+// Detect: the library reopens the device and restores the lighting on
+// hotplug; we only forward the connection state
+// ------------------------------------------------------------------
+void DeviceWorker::detect(bool startup)
+{
+    QString how;
+    if (kb_.isOpen())                   how = "connected";
+    else if (kb_.autoDetect())          how = startup ? "auto-detected" : "connected";
+    else if (!startup && kb_.open())    how = "connected (default)";
+
+    if (how.isEmpty()) {
+        emit detected(startup, false, 0, 0, how);
+        return;
+    }
+
+    kb_.enableHotplug([this](bool connected) { emit connectionChanged(connected); });
+    emit detected(startup, true, kb_.getVid(), kb_.getPid(), how);
+}
+
+// Synchronous sends first take back whatever preview is still queued
+// for the writer thread, so a stale frame can't land on top of them.
+void DeviceWorker::apply(const LAParams& p, int fadeMs)
+{
+    kb_.cancelPosted();
+    bool ok = fadeMs > 0 ? kb_.transition(p, std::chrono::milliseconds(fadeMs))
+                         : kb_.apply(p);
+    if (ok) rememberShown();
+    emit applied(ok);
+}
+
+void DeviceWorker::applyEncoded(const LAPacket& payload)
+{
+    kb_.cancelPosted();
+    bool ok = kb_.applyEncoded(payload);
+    if (ok) rememberShown();
+    emit applied(ok);
+}
+
+void DeviceWorker::turnOff()
+{
+    kb_.cancelPosted();
+    bool ok = kb_.off();
+    if (ok) rememberShown();
+    emit turnedOff(ok);
+}
+
+void DeviceWorker::setLevel(int percent)
+{
+    kb_.setSoftwareBrightness((float)percent);
+}
+
+// ------------------------------------------------------------------
+// Preview
+// ------------------------------------------------------------------
+void DeviceWorker::beginPreview()
+{
+    if (!shown_) rememberShown();   // nothing applied yet: remember what the device shows
+}
+
+void DeviceWorker::preview(const LAParams& p)
+{
+    kb_.post(p);
+    reportInterval();
+}
+
+// Kept: the last preview frame still lands. Cancelled: the saved packet
+// is what the device showed, already color corrected, so it goes back
+// out as is rather than through post().
+void DeviceWorker::endPreview(bool keep)
+{
+    if (keep) {
+        kb_.flushPosted();
+        return;
+    }
+    kb_.cancelPosted();
+    if (shown_) kb_.sendPacket(*shown_);
+}
+
+// What the device shows: the library's shadow copy, so this costs no
+// transfer once something has been applied
+void DeviceWorker::rememberShown()
+{
+    LAParams cur;
+    if (kb_.currentColors(cur)) shown_ = laEncode(cur);
+}
+
+// One frame per smoothed round trip (plus headroom), at most ~60 fps
+void DeviceWorker::reportInterval()
+{
+    const uint32_t rtt = kb_.transferRttUs();
+    const int ms = std::max(16, (int)((rtt + rtt / 4 + 999) / 1000));
+    if (ms == intervalMs_) return;
+    intervalMs_ = ms;
+    emit frameIntervalChanged(ms);
+}
+
+void DeviceWorker::shutdown()
+{
+    kb_.close();
+}
@@ -0,0 +1,55 @@
+// /LegionAura/gui/DeviceWorker.h
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <optional>
+#include "legionaura.h"
+#include "packet.h"
+
+Q_DECLARE_METATYPE(LAParams)
+Q_DECLARE_METATYPE(LAPacket)
+
+// ------------------------------------------------------------------
+// Owns the LegionAura instance on its own QThread. MainWindow talks to
+// it only through queued signals, so slow or missing devices (libusb
+// calls block up to the transfer timeout) never freeze the window.
+// ------------------------------------------------------------------
+class DeviceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceWorker(QObject *parent = nullptr);
+    ~DeviceWorker() override;
+
+public slots:
+    void detect(bool startup);                 // startup: known models only, no permission hints
+    void apply(const LAParams& p, int fadeMs);
+    void applyEncoded(const LAPacket& payload);   // saved profile, see profiles.h
+    void turnOff();
+    void setLevel(int percent);
+
+    // Live preview while a color picker is open. Frames go through the
+    // latest-wins mailbox, so the device always shows the newest color.
+    void beginPreview();
+    void preview(const LAParams& p);
+    void endPreview(bool keep);                // !keep: go back to the last applied state
+
+    void shutdown();                           // closes the device on this thread
+
+signals:
+    void detected(bool startup, bool ok, quint16 vid, quint16 pid, const QString& how);
+    void applied(bool ok);
+    void turnedOff(bool ok);
+    void connectionChanged(bool connected);    // hotplug, emitted from libusb's thread
+    void frameIntervalChanged(int ms);         // pace for previews, from the measured round trip
+
+private:
+    void reportInterval();
+    void rememberShown();
+
+    LegionAura kb_;
+    std::optional<LAPacket> shown_;            // device state after the last send, restored after a cancelled preview
+    int intervalMs_ = 0;
+};
@@ -6,28 +6,24 @@
 #include <QPushButton>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QSlider>
 #include <QStatusBar>
 #include <QSettings>
 #include <QPalette>
 #include <QStyleFactory>
 #include <QTimer>
-#include <map>
+
+#include "device_table.h"
+#include "DeviceWorker.h"
+#include "profiles.h"
 
 // ------------------------------------------------------------------
 // Device name resolver
 // ------------------------------------------------------------------
-static QString resolveDeviceName(uint16_t pid)
+static QString resolveDeviceName(uint16_t vid, uint16_t pid)
 {
-    static const std::map<uint16_t, QString> names = {
-        {0xC993, "Lenovo LOQ"},
-        {0xC996, "Lenovo Legion"},
-        {0xC963, "Lenovo IdeaPad Gaming"},
-        {0xC968, "Lenovo Legion 7 (2022)"}
-    };
-
-    auto it = names.find(pid);
-    if (it != names.end())
-        return it->second;
+    if (const LADeviceInfo* d = LADeviceRegistry::instance().find(vid, pid))
+        return QString("%1 (%2)").arg(QString::fromUtf8(d->name)).arg(d->year);
 
     return "Lenovo (Unknown Model)";
 }
@@ -41,6 +37,44 @@ MainWindow::MainWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // All USB I/O happens on the worker thread; every call below is a
+    // queued signal, so a slow or absent device never blocks the window
+    qRegisterMetaType<LAParams>("LAParams");
+    qRegisterMetaType<LAPacket>("LAPacket");
+    worker_ = new DeviceWorker;
+    worker_->moveToThread(&ioThread_);
+
+    connect(this, &MainWindow::requestDetect,       worker_, &DeviceWorker::detect);
+    connect(this, &MainWindow::requestApply,        worker_, &DeviceWorker::apply);
+    connect(this, &MainWindow::requestApplyEncoded, worker_, &DeviceWorker::applyEncoded);
+    connect(this, &MainWindow::requestOff,          worker_, &DeviceWorker::turnOff);
+    connect(this, &MainWindow::requestLevel,        worker_, &DeviceWorker::setLevel);
+    connect(this, &MainWindow::requestBeginPreview, worker_, &DeviceWorker::beginPreview);
+    connect(this, &MainWindow::requestPreview,      worker_, &DeviceWorker::preview);
+    connect(this, &MainWindow::requestEndPreview,   worker_, &DeviceWorker::endPreview);
+
+    connect(worker_, &DeviceWorker::detected,          this, &MainWindow::onDetected);
+    connect(worker_, &DeviceWorker::connectionChanged, this, &MainWindow::onConnectionChanged);
+    connect(worker_, &DeviceWorker::applied, this, [this](bool ok) {
+        ui->btnApply->setEnabled(true);
+        if (ok) setStatusOk("Lighting updated.");
+        else    setStatusErr("Failed to send command.");
+    });
+    connect(worker_, &DeviceWorker::turnedOff, this, [this](bool ok) {
+        ui->btnOff->setEnabled(true);
+        if (ok) setStatusOk("Keyboard turned off.");
+        else    setStatusErr("Failed to send off command.");
+    });
+    connect(worker_, &DeviceWorker::frameIntervalChanged, this, [this](int ms) {
+        previewTimer_.setInterval(ms);
+    });
+
+    ioThread_.start();
+
+    previewTimer_.setSingleShot(true);
+    previewTimer_.setInterval(16);
+    connect(&previewTimer_, &QTimer::timeout, this, &MainWindow::flushPreview);
+
     // Auto-detect device shortly after app start
     QTimer::singleShot(100, this, &MainWindow::autoDetectOnStartup);
 
@@ -62,6 +96,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnDetect, &QPushButton::clicked, this, &MainWindow::onDetectClicked);
     connect(ui->btnApply,  &QPushButton::clicked, this, &MainWindow::onApplyClicked);
     connect(ui->btnOff,    &QPushButton::clicked, this, &MainWindow::onOffClicked);
+    connect(ui->btnProfileApply, &QPushButton::clicked, this, &MainWindow::onProfileApplyClicked);
+    connect(ui->btnProfileSave,  &QPushButton::clicked, this, &MainWindow::onProfileSaveClicked);
 
     connect(ui->btnColor1, &QPushButton::clicked, this, &MainWindow::onPickZ1);
     connect(ui->btnColor2, &QPushButton::clicked, this, &MainWindow::onPickZ2);
@@ -71,14 +107,25 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->comboEffect, qOverload<int>(&QComboBox::currentIndexChanged),
             this, &MainWindow::onEffectChanged);
 
+    connect(ui->sliderLevel, &QSlider::valueChanged, this, &MainWindow::onLevelChanged);
+    connect(ui->sliderLevel, &QSlider::sliderReleased, this, [this]{
+        if (deviceReady_) onApplyClicked();
+    });
+
     // Initial UI state
     onEffectChanged(ui->comboEffect->currentIndex());
     ui->lblDeviceLeft->setText("Device: (not connected)");
     ui->lblDeviceName->setText("");
+    reloadProfiles(QSettings().value("profiles/last").toString());
 }
 
 MainWindow::~MainWindow()
 {
+    // Close the device on its own thread (after any queued work), then stop it
+    QMetaObject::invokeMethod(worker_, &DeviceWorker::shutdown, Qt::BlockingQueuedConnection);
+    ioThread_.quit();
+    ioThread_.wait();
+    delete worker_;
     delete ui;
 }
 
@@ -87,62 +134,104 @@ MainWindow::~MainWindow()
 // ------------------------------------------------------------------
 void MainWindow::onDetectClicked()
 {
-    if (kb_.autoDetect()) {
-        deviceReady_ = true;
+    ui->btnDetect->setEnabled(false);
+    emit requestDetect(false);
+}
 
-        QString name = resolveDeviceName(kb_.getPid());
-        ui->lblDeviceLeft->setText("Device: connected");
-        ui->lblDeviceName->setText(name);
+// ------------------------------------------------------------------
+// Auto detect on startup
+// ------------------------------------------------------------------
+void MainWindow::autoDetectOnStartup()
+{
+    emit requestDetect(true);
+}
 
-        setStatusOk("Device connected");
-        return;
-    }
+void MainWindow::onDetected(bool startup, bool ok, quint16 vid, quint16 pid, const QString& how)
+{
+    ui->btnDetect->setEnabled(true);
 
-    if (kb_.open()) {
+    if (ok) {
         deviceReady_ = true;
-
-        QString name = resolveDeviceName(kb_.getPid());
         ui->lblDeviceLeft->setText("Device: connected");
-        ui->lblDeviceName->setText(name);
-
-        setStatusOk("Device connected (default)");
-    } else {
-        deviceReady_ = false;
+        ui->lblDeviceName->setText(resolveDeviceName(vid, pid));
+        setStatusOk("Device " + how);
+        return;
+    }
 
-        ui->lblDeviceLeft->setText("Device: (not connected)");
-        ui->lblDeviceName->setText("");
+    // A failed startup probe stays quiet
+    if (startup) return;
 
-        setStatusErr("Failed to open device. Try installing udev rules.");
-    }
+    deviceReady_ = false;
+    ui->lblDeviceLeft->setText("Device: (not connected)");
+    ui->lblDeviceName->setText("");
+    setStatusErr("Failed to open device. Try installing udev rules.");
 }
 
 // ------------------------------------------------------------------
-// Auto detect on startup
+// Hotplug: the library reopens the device and restores the lighting;
+// we only mirror the connection state
 // ------------------------------------------------------------------
-void MainWindow::autoDetectOnStartup()
+void MainWindow::onConnectionChanged(bool connected)
 {
-    if (kb_.autoDetect()) {
-        deviceReady_ = true;
-
-        ui->lblDeviceLeft->setText("Device: connected");
-        ui->lblDeviceName->setText(resolveDeviceName(kb_.getPid()));
-
-        setStatusOk("Device auto-detected");
-    }
+    deviceReady_ = connected;
+    ui->lblDeviceLeft->setText(connected ? "Device: connected"
+                                         : "Device: (disconnected)");
+    if (connected) setStatusOk("Device reconnected, lighting restored");
+    else           setStatusErr("Device disconnected, waiting for it to return.");
 }
 
 // ------------------------------------------------------------------
 // Color picker helpers
 // ------------------------------------------------------------------
-std::optional<QString> MainWindow::pickHexColor(const QString &initialHex)
+// While the dialog is open the keyboard follows the picker: zone `zone`
+// takes the color under the cursor, the rest come from the UI. Cancel
+// puts back what was last applied.
+std::optional<QString> MainWindow::pickHexColor(const QString &initialHex, int zone)
 {
     QColor initial = hexToRgb(initialHex).value_or(QColor(255,0,0));
-    QColor c = QColorDialog::getColor(initial, this, "Pick Color");
+    QColorDialog dlg(initial, this);
+    dlg.setWindowTitle("Pick Color");
+
+    const bool live = deviceReady_;
+    if (live) {
+        emit requestBeginPreview();
+        connect(&dlg, &QColorDialog::currentColorChanged, this, [this, zone](const QColor& c) {
+            if (auto p = buildParamsFromUi(std::make_pair(zone, rgbToHex(c))))
+                schedulePreview(*p);
+        });
+    }
+
+    const bool accepted = dlg.exec() == QDialog::Accepted && dlg.selectedColor().isValid();
 
-    if (!c.isValid())
+    if (live) {
+        pendingPreview_.reset();
+        previewTimer_.stop();
+        emit requestEndPreview(accepted);
+    }
+
+    if (!accepted)
         return std::nullopt;
 
-    return rgbToHex(c);
+    return rgbToHex(dlg.selectedColor());
+}
+
+// ------------------------------------------------------------------
+// Preview throttle: the first color goes out at once, later ones are
+// held and only the newest is sent when the interval (one device round
+// trip, reported by the worker) has passed
+// ------------------------------------------------------------------
+void MainWindow::schedulePreview(const LAParams& p)
+{
+    pendingPreview_ = p;
+    if (!previewTimer_.isActive()) flushPreview();
+}
+
+void MainWindow::flushPreview()
+{
+    if (!pendingPreview_) return;
+    emit requestPreview(*pendingPreview_);
+    pendingPreview_.reset();
+    previewTimer_.start();
 }
 
 QString MainWindow::rgbToHex(const QColor &c)
@@ -179,7 +268,7 @@ void MainWindow::setBtnSwatch(QPushButton* btn, const QString& hex)
 // ------------------------------------------------------------------
 void MainWindow::onPickZ1()
 {
-    auto val = pickHexColor(ui->editZ1->text());
+    auto val = pickHexColor(ui->editZ1->text(), 0);
     if (!val) return;
     ui->editZ1->setText(*val);
     setBtnSwatch(ui->btnColor1, *val);
@@ -187,7 +276,7 @@ void MainWindow::onPickZ1()
 
 void MainWindow::onPickZ2()
 {
-    auto val = pickHexColor(ui->editZ2->text());
+    auto val = pickHexColor(ui->editZ2->text(), 1);
     if (!val) return;
     ui->editZ2->setText(*val);
     setBtnSwatch(ui->btnColor2, *val);
@@ -195,7 +284,7 @@ void MainWindow::onPickZ2()
 
 void MainWindow::onPickZ3()
 {
-    auto val = pickHexColor(ui->editZ3->text());
+    auto val = pickHexColor(ui->editZ3->text(), 2);
     if (!val) return;
     ui->editZ3->setText(*val);
     setBtnSwatch(ui->btnColor3, *val);
@@ -203,7 +292,7 @@ void MainWindow::onPickZ3()
 
 void MainWindow::onPickZ4()
 {
-    auto val = pickHexColor(ui->editZ4->text());
+    auto val = pickHexColor(ui->editZ4->text(), 3);
     if (!val) return;
     ui->editZ4->setText(*val);
     setBtnSwatch(ui->btnColor4, *val);
@@ -232,6 +321,19 @@ void MainWindow::onEffectChanged(int idx)
     ui->chkAutofill->setEnabled(needsColors);
 
     ui->comboDirection->setEnabled(needsDir);
+
+    // Wave/Hue colors are generated by the controller, so only the
+    // hardware brightness applies to them
+    ui->sliderLevel->setEnabled(needsColors);
+}
+
+// ------------------------------------------------------------------
+// Software brightness: rebuilds the color tables, applied on release
+// ------------------------------------------------------------------
+void MainWindow::onLevelChanged(int value)
+{
+    emit requestLevel(value);
+    ui->lblLevel->setText(QString("Level %1%").arg(value));
 }
 
 // ------------------------------------------------------------------
@@ -250,7 +352,8 @@ std::array<QString,4> MainWindow::normalize4(const std::vector<QString> &in)
 // ------------------------------------------------------------------
 // Build params from UI
 // ------------------------------------------------------------------
-std::optional<LAParams> MainWindow::buildParamsFromUi() const
+std::optional<LAParams> MainWindow::buildParamsFromUi(
+    std::optional<std::pair<int,QString>> zoneOverride) const
 {
     QString mode = ui->comboEffect->currentText().toLower();
 
@@ -273,13 +376,16 @@ std::optional<LAParams> MainWindow::buildParamsFromUi() const
 
     if (p.effect == LAEffect::Static || p.effect == LAEffect::Breath) {
         std::vector<QString> cols;
+        const QLineEdit* edits[4] = { ui->editZ1, ui->editZ2, ui->editZ3, ui->editZ4 };
 
-        if (!ui->editZ1->text().isEmpty()) cols.push_back(ui->editZ1->text());
-        if (!ui->editZ2->text().isEmpty()) cols.push_back(ui->editZ2->text());
-        if (!ui->editZ3->text().isEmpty()) cols.push_back(ui->editZ3->text());
-        if (!ui->editZ4->text().isEmpty()) cols.push_back(ui->editZ4->text());
+        for (int i = 0; i < 4; i++) {
+            QString t = (zoneOverride && zoneOverride->first == i)
+                      ? zoneOverride->second : edits[i]->text();
+            if (!t.isEmpty()) cols.push_back(t);
+        }
 
         if (cols.empty()) return std::nullopt;
+        if (!ui->chkAutofill->isChecked() && cols.size() < 4) return std::nullopt;
 
         auto normalized = ui->chkAutofill->isChecked()
                         ? normalize4(cols)
@@ -315,9 +421,10 @@ void MainWindow::onApplyClicked()
         return;
     }
 
-    bool ok = kb_.apply(*params);
-    if (ok) setStatusOk("Lighting updated.");
-    else    setStatusErr("Failed to send command.");
+    // The worker replies with applied(); a fade streams frames for its
+    // whole duration, so Apply stays disabled until it finishes
+    ui->btnApply->setEnabled(false);
+    emit requestApply(*params, ui->spinFade->value());
 }
 
 // ------------------------------------------------------------------
@@ -330,10 +437,83 @@ void MainWindow::onOffClicked()
         return;
     }
 
-    if (kb_.off())
-        setStatusOk("Keyboard turned off.");
+    ui->btnOff->setEnabled(false);
+    emit requestOff();
+}
+
+// ------------------------------------------------------------------
+// PROFILES: same file as the CLI, re-read on every use so changes made
+// from a terminal show up. The packet is applied as saved; a Fade
+// decodes it and blends like a normal Apply.
+// ------------------------------------------------------------------
+void MainWindow::reloadProfiles(const QString& select)
+{
+    LAProfileStore store;
+    std::string err;
+    if (!store.load(err)) setStatusErr(QString::fromStdString(err));
+
+    ui->comboProfile->clear();
+    for (auto& name : store.names())
+        ui->comboProfile->addItem(QString::fromStdString(name));
+
+    int idx = ui->comboProfile->findText(select);
+    if (idx >= 0) ui->comboProfile->setCurrentIndex(idx);
+    else          ui->comboProfile->setEditText(select);
+}
+
+void MainWindow::onProfileApplyClicked()
+{
+    if (!deviceReady_) {
+        setStatusErr("Device not connected.");
+        return;
+    }
+
+    const QString name = ui->comboProfile->currentText();
+    LAProfileStore store;
+    std::string err;
+    const LAPacket* pkt = store.load(err) ? store.find(name.toStdString()) : nullptr;
+    if (!pkt) {
+        setStatusErr("No profile named " + name);
+        return;
+    }
+    QSettings().setValue("profiles/last", name);
+
+    ui->btnApply->setEnabled(false);
+    LAParams p;
+    const int fadeMs = ui->spinFade->value();
+    if (fadeMs > 0 && laDecode(pkt->data(), pkt->size(), p))
+        emit requestApply(p, fadeMs);
     else
-        setStatusErr("Failed to send off command.");
+        emit requestApplyEncoded(*pkt);
+}
+
+void MainWindow::onProfileSaveClicked()
+{
+    const QString name = ui->comboProfile->currentText().trimmed();
+    if (!LAProfileStore::validName(name.toStdString())) {
+        setStatusErr("Profile names are 1-31 characters without spaces or '/'.");
+        return;
+    }
+
+    auto params = buildParamsFromUi();
+    if (!params) {
+        setStatusErr("Invalid color values.");
+        return;
+    }
+
+    LAProfileStore store;
+    std::string err;
+    if (store.load(err)) {
+        store.put(name.toStdString(), laEncode(*params));
+        store.save(err);
+    }
+    if (!err.empty()) {
+        setStatusErr(QString::fromStdString(err));
+        return;
+    }
+    QSettings().setValue("profiles/last", name);
+    reloadProfiles(name);
+    setStatusOk("Saved profile " + name);
 }
 
 // ------------------------------------------------------------------
@@ -4,9 +4,15 @@
 #include <QMainWindow>
 #include <QPushButton>
 #include <QColor>
+#include <QThread>
+#include <QTimer>
 #include <array>
 #include <optional>
+#include <utility>
 #include "legionaura.h"
+#include "packet.h"
+
+class DeviceWorker;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -40,23 +46,55 @@ private slots:
     // Effect changes (enable/disable controls as needed)
     void onEffectChanged(int index);
 
+    // Software brightness slider (0..100%)
+    void onLevelChanged(int value);
+
+    // Saved profiles (shared with `legionaura profile`)
+    void onProfileApplyClicked();
+    void onProfileSaveClicked();
+
+    // Replies from the device worker
+    void onDetected(bool startup, bool ok, quint16 vid, quint16 pid, const QString& how);
+    void onConnectionChanged(bool connected);
+
+signals:
+    // Queued to the device worker's thread
+    void requestDetect(bool startup);
+    void requestApply(const LAParams& p, int fadeMs);
+    void requestApplyEncoded(const LAPacket& payload);
+    void requestOff();
+    void requestLevel(int percent);
+    void requestBeginPreview();
+    void requestPreview(const LAParams& p);
+    void requestEndPreview(bool keep);
+
 private:
-    std::optional<QString> pickHexColor(const QString &initialHex);
+    std::optional<QString> pickHexColor(const QString &initialHex, int zone);
+    void schedulePreview(const LAParams& p);
+    void flushPreview();
     static QString rgbToHex(const QColor &c);
     static std::optional<QColor> hexToRgb(const QString &hex);
 
     void setBtnSwatch(QPushButton* btn, const QString& hex);
+    void reloadProfiles(const QString& select);
     void setStatusOk(const QString& msg);
     void setStatusErr(const QString& msg);
 
     // Build LAParams from current UI state (with auto-fill if checked)
-    std::optional<LAParams> buildParamsFromUi() const;
+    // zoneOverride replaces one zone's text (the color being picked)
+    std::optional<LAParams> buildParamsFromUi(
+        std::optional<std::pair<int,QString>> zoneOverride = std::nullopt) const;
 
     // Normalize 1..3 colors to 4 (same rule as CLI)
     static std::array<QString,4> normalize4(const std::vector<QString>& in);
 
 private:
     Ui::MainWindow *ui;
-    LegionAura kb_;
+    QThread ioThread_;
+    DeviceWorker *worker_ = nullptr;   // lives on ioThread_
     bool deviceReady_ = false;
+
+    // Live preview: at most one frame per interval, newest color wins
+    QTimer previewTimer_;
+    std::optional<LAParams> pendingPreview_;
 };
\ No newline at end of file
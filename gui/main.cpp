@@ -5,6 +5,8 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    a.setOrganizationName("LegionAura");   // QSettings location
+    a.setApplicationName("legionaura-gui");
     MainWindow w;
     w.show();
     return a.exec();
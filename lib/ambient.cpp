@@ -0,0 +1,354 @@
+// /LegionAura/lib/ambient.cpp
+
+#include <algorithm>
+#include <cstring>
+
+#include "ambient.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LA_HAVE_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LA_HAVE_AVX2 1
+#endif
+
+// ------------------------------------------------------
+// Average kernels.
+// Each one adds the bytes of a row span into acc[0..2] by byte position
+// within the pixel (the 4th byte of BGRA is skipped). All of them give
+// exactly the scalar sums.
+//
+// RGB24: a 3-byte pixel repeats every 3 vectors, so the SIMD versions
+// walk blocks of 3 vectors, mask one channel at a time and let SAD
+// against zero do the horizontal add into 64-bit lanes.
+//
+// BGRA32: the layout repeats every 4 bytes, so one AND and one shift
+// split a vector into 16-bit words (B,R) and (G,A) that add up
+// directly. A word gains at most 255 per vector, so they are widened
+// into the 64-bit totals every 256 vectors, before they can overflow.
+// ------------------------------------------------------
+using LASpanSumFn = void (*)(const uint8_t* p, size_t bytes, size_t bpp, uint64_t acc[3]);
+
+static void spanSumScalar(const uint8_t* p, size_t bytes, size_t bpp, uint64_t acc[3]) {
+    uint64_t a = 0, b = 0, c = 0;
+    for (size_t i = 0; i < bytes; i += bpp) {
+        a += p[i];
+        b += p[i + 1];
+        c += p[i + 2];
+    }
+    acc[0] += a; acc[1] += b; acc[2] += c;
+}
+
+// mask[v][ch][i] selects the bytes of channel ch in vector v of an RGB24 block
+template <size_t W>
+struct LAMaskTable {
+    uint8_t mask[3][3][W];
+    LAMaskTable() {
+        for (size_t v = 0; v < 3; ++v)
+            for (size_t ch = 0; ch < 3; ++ch)
+                for (size_t i = 0; i < W; ++i)
+                    mask[v][ch][i] = ((v * W + i) % 3 == ch) ? 0xFF : 0x00;
+    }
+};
+
+template <size_t W>
+static const LAMaskTable<W>& rgbMasks() {
+    static const LAMaskTable<W> t;
+    return t;
+}
+
+// Adds the 32-bit lanes of b (low words = byte 0), r (high words = byte 2)
+// and g (low words = byte 1) into acc
+template <size_t N>
+static inline void addLanes(const uint32_t (&b)[N], const uint32_t (&g)[N], const uint32_t (&r)[N],
+                            uint64_t acc[3]) {
+    for (size_t k = 0; k < N; ++k) { acc[0] += b[k]; acc[1] += g[k]; acc[2] += r[k]; }
+}
+
+#ifdef LA_HAVE_SSE2
+static void spanSumRgbSse2(const uint8_t* p, size_t bytes, uint64_t acc[3]) {
+    const auto& t = rgbMasks<16>();
+    __m128i m[3][3];
+    for (size_t v = 0; v < 3; ++v)
+        for (size_t ch = 0; ch < 3; ++ch)
+            m[v][ch] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.mask[v][ch]));
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i s0 = zero, s1 = zero, s2 = zero;
+    size_t i = 0;
+    for (; i + 48 <= bytes; i += 48) {
+        for (size_t v = 0; v < 3; ++v) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + v * 16));
+            s0 = _mm_add_epi64(s0, _mm_sad_epu8(_mm_and_si128(x, m[v][0]), zero));
+            s1 = _mm_add_epi64(s1, _mm_sad_epu8(_mm_and_si128(x, m[v][1]), zero));
+            s2 = _mm_add_epi64(s2, _mm_sad_epu8(_mm_and_si128(x, m[v][2]), zero));
+        }
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), s0); acc[0] += lanes[0] + lanes[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), s1); acc[1] += lanes[0] + lanes[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), s2); acc[2] += lanes[0] + lanes[1];
+
+    spanSumScalar(p + i, bytes - i, 3, acc);
+}
+
+static void spanSumBgraSse2(const uint8_t* p, size_t bytes, uint64_t acc[3]) {
+    const __m128i byteLo = _mm_set1_epi16(0x00FF), wordLo = _mm_set1_epi32(0xFFFF);
+    size_t i = 0;
+    while (i + 16 <= bytes) {
+        __m128i br = _mm_setzero_si128(), ga = br;
+        for (int n = 0; n < 256 && i + 16 <= bytes; ++n, i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            br = _mm_add_epi16(br, _mm_and_si128(x, byteLo));
+            ga = _mm_add_epi16(ga, _mm_srli_epi16(x, 8));
+        }
+        alignas(16) uint32_t b[4], g[4], r[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(b), _mm_and_si128(br, wordLo));
+        _mm_store_si128(reinterpret_cast<__m128i*>(g), _mm_and_si128(ga, wordLo));
+        _mm_store_si128(reinterpret_cast<__m128i*>(r), _mm_srli_epi32(br, 16));
+        addLanes(b, g, r, acc);
+    }
+    spanSumScalar(p + i, bytes - i, 4, acc);
+}
+
+static void spanSumSse2(const uint8_t* p, size_t bytes, size_t bpp, uint64_t acc[3]) {
+    if (bpp == 4) spanSumBgraSse2(p, bytes, acc);
+    else          spanSumRgbSse2(p, bytes, acc);
+}
+#endif
+
+#ifdef LA_HAVE_AVX2
+__attribute__((target("avx2")))
+static void spanSumRgbAvx2(const uint8_t* p, size_t bytes, uint64_t acc[3]) {
+    const auto& t = rgbMasks<32>();
+    __m256i m[3][3];
+    for (size_t v = 0; v < 3; ++v)
+        for (size_t ch = 0; ch < 3; ++ch)
+            m[v][ch] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t.mask[v][ch]));
+
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i s0 = zero, s1 = zero, s2 = zero;
+    size_t i = 0;
+    for (; i + 96 <= bytes; i += 96) {
+        for (size_t v = 0; v < 3; ++v) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + v * 32));
+            s0 = _mm256_add_epi64(s0, _mm256_sad_epu8(_mm256_and_si256(x, m[v][0]), zero));
+            s1 = _mm256_add_epi64(s1, _mm256_sad_epu8(_mm256_and_si256(x, m[v][1]), zero));
+            s2 = _mm256_add_epi64(s2, _mm256_sad_epu8(_mm256_and_si256(x, m[v][2]), zero));
+        }
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s0); acc[0] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s1); acc[1] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s2); acc[2] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    spanSumScalar(p + i, bytes - i, 3, acc);
+}
+
+__attribute__((target("avx2")))
+static void spanSumBgraAvx2(const uint8_t* p, size_t bytes, uint64_t acc[3]) {
+    const __m256i byteLo = _mm256_set1_epi16(0x00FF), wordLo = _mm256_set1_epi32(0xFFFF);
+    size_t i = 0;
+    while (i + 32 <= bytes) {
+        __m256i br = _mm256_setzero_si256(), ga = br;
+        for (int n = 0; n < 256 && i + 32 <= bytes; ++n, i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            br = _mm256_add_epi16(br, _mm256_and_si256(x, byteLo));
+            ga = _mm256_add_epi16(ga, _mm256_srli_epi16(x, 8));
+        }
+        alignas(32) uint32_t b[8], g[8], r[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(b), _mm256_and_si256(br, wordLo));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(g), _mm256_and_si256(ga, wordLo));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(r), _mm256_srli_epi32(br, 16));
+        addLanes(b, g, r, acc);
+    }
+    spanSumScalar(p + i, bytes - i, 4, acc);
+}
+
+__attribute__((target("avx2")))
+static void spanSumAvx2(const uint8_t* p, size_t bytes, size_t bpp, uint64_t acc[3]) {
+    if (bpp == 4) spanSumBgraAvx2(p, bytes, acc);
+    else          spanSumRgbAvx2(p, bytes, acc);
+}
+#endif
+
+static LASpanSumFn spanSumFor(LAAmbientKernel k) {
+    switch (k) {
+#ifdef LA_HAVE_AVX2
+    case LAAmbientKernel::AVX2: return spanSumAvx2;
+#endif
+#ifdef LA_HAVE_SSE2
+    case LAAmbientKernel::SSE2: return spanSumSse2;
+#endif
+    default: return spanSumScalar;
+    }
+}
+
+bool LAAmbientReducer::kernelAvailable(LAAmbientKernel k) {
+    switch (k) {
+    case LAAmbientKernel::Auto:
+    case LAAmbientKernel::Scalar:
+        return true;
+    case LAAmbientKernel::SSE2:
+#ifdef LA_HAVE_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case LAAmbientKernel::AVX2:
+#ifdef LA_HAVE_AVX2
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* LAAmbientReducer::kernelName(LAAmbientKernel k) {
+    switch (k) {
+    case LAAmbientKernel::Auto:   return "auto";
+    case LAAmbientKernel::Scalar: return "scalar";
+    case LAAmbientKernel::SSE2:   return "sse2";
+    case LAAmbientKernel::AVX2:   return "avx2";
+    }
+    return "?";
+}
+
+// REDUCER ----------------------------------------------------------
+
+LAAmbientReducer::LAAmbientReducer(int width, int height, LAPixelFormat fmt, size_t rowBytes)
+    : width_(std::max(4, width)), height_(std::max(1, height)), fmt_(fmt),
+      bpp_(fmt == LAPixelFormat::RGB24 ? 3 : 4)
+{
+    rowBytes_ = rowBytes ? rowBytes : (size_t)width_ * bpp_;
+    for (int z = 0; z <= 4; ++z) zoneX_[z] = width_ * z / 4;
+    setOptions(opt_);
+}
+
+void LAAmbientReducer::setOptions(const LAAmbientOptions& o) {
+    opt_ = o;
+    opt_.xStep = std::max(1, o.xStep);
+    opt_.yStep = o.yStep > 0 ? o.yStep : std::max(1, height_ / LA_AMBIENT_ROWS);
+
+    if (o.kernel == LAAmbientKernel::Auto) {
+        kernel_ = kernelAvailable(LAAmbientKernel::AVX2) ? LAAmbientKernel::AVX2
+                : kernelAvailable(LAAmbientKernel::SSE2) ? LAAmbientKernel::SSE2
+                : LAAmbientKernel::Scalar;
+    } else {
+        kernel_ = kernelAvailable(o.kernel) ? o.kernel : LAAmbientKernel::Scalar;
+    }
+
+    if (opt_.mode == LAAmbientMode::Dominant) {
+        bucketCount_.assign(4 * 4096, 0);
+        bucketSum_.assign(4 * 4096 * 3, 0);
+    } else {
+        bucketCount_.clear();
+        bucketSum_.clear();
+    }
+}
+
+LAZoneFrame LAAmbientReducer::reduce(const uint8_t* frame) {
+    return opt_.mode == LAAmbientMode::Dominant ? reduceDominant(frame) : reduceAverage(frame);
+}
+
+// Byte position within a pixel -> LAColor channel
+static LAColor toColor(LAPixelFormat fmt, uint64_t c0, uint64_t c1, uint64_t c2) {
+    if (fmt == LAPixelFormat::BGRA32) return LAColor{(uint8_t)c2, (uint8_t)c1, (uint8_t)c0};
+    return LAColor{(uint8_t)c0, (uint8_t)c1, (uint8_t)c2};
+}
+
+LAZoneFrame LAAmbientReducer::reduceAverage(const uint8_t* frame) {
+    const LASpanSumFn sum = spanSumFor(kernel_);
+    const size_t xs = (size_t)opt_.xStep;
+    uint64_t acc[4][3] = {};
+    uint64_t rows = 0;
+
+    for (int y = 0; y < height_; y += opt_.yStep, ++rows) {
+        const uint8_t* row = frame + (size_t)y * rowBytes_;
+        for (int z = 0; z < 4; ++z) {
+            const uint8_t* p = row + (size_t)zoneX_[z] * bpp_;
+            size_t bytes = (size_t)(zoneX_[z + 1] - zoneX_[z]) * bpp_;
+            if (xs == 1) {
+                sum(p, bytes, bpp_, acc[z]);
+                continue;
+            }
+            for (size_t i = 0; i < bytes; i += xs * bpp_) {
+                acc[z][0] += p[i];
+                acc[z][1] += p[i + 1];
+                acc[z][2] += p[i + 2];
+            }
+        }
+    }
+
+    LAZoneFrame out{};
+    for (int z = 0; z < 4; ++z) {
+        uint64_t cols = ((uint64_t)(zoneX_[z + 1] - zoneX_[z]) + xs - 1) / xs;
+        uint64_t n = std::max<uint64_t>(1, rows * cols);
+        out[z] = toColor(fmt_, acc[z][0] / n, acc[z][1] / n, acc[z][2] / n);
+    }
+    return out;
+}
+
+LAZoneFrame LAAmbientReducer::reduceDominant(const uint8_t* frame) {
+    std::fill(bucketCount_.begin(), bucketCount_.end(), 0);
+    std::fill(bucketSum_.begin(), bucketSum_.end(), 0);
+    const size_t xs = (size_t)opt_.xStep;
+
+    for (int y = 0; y < height_; y += opt_.yStep) {
+        const uint8_t* row = frame + (size_t)y * rowBytes_;
+        for (int z = 0; z < 4; ++z) {
+            uint32_t* count = bucketCount_.data() + z * 4096;
+            uint32_t* sums = bucketSum_.data() + z * 4096 * 3;
+            const uint8_t* p = row + (size_t)zoneX_[z] * bpp_;
+            size_t bytes = (size_t)(zoneX_[z + 1] - zoneX_[z]) * bpp_;
+            for (size_t i = 0; i < bytes; i += xs * bpp_) {
+                uint32_t b = ((uint32_t)(p[i] >> 4) << 8) | ((p[i + 1] >> 4) << 4) | (p[i + 2] >> 4);
+                count[b]++;
+                sums[b * 3]     += p[i];
+                sums[b * 3 + 1] += p[i + 1];
+                sums[b * 3 + 2] += p[i + 2];
+            }
+        }
+    }
+
+    LAZoneFrame out{};
+    for (int z = 0; z < 4; ++z) {
+        const uint32_t* count = bucketCount_.data() + z * 4096;
+        const uint32_t* sums = bucketSum_.data() + z * 4096 * 3;
+        size_t best = (size_t)(std::max_element(count, count + 4096) - count);
+        uint32_t n = std::max<uint32_t>(1, count[best]);
+        out[z] = toColor(fmt_, sums[best * 3] / n, sums[best * 3 + 1] / n, sums[best * 3 + 2] / n);
+    }
+    return out;
+}
+
+// FRAME READER -----------------------------------------------------
+
+LARawFrameReader::~LARawFrameReader() {
+    if (f_ && ownsFile_) std::fclose(f_);
+}
+
+bool LARawFrameReader::open(const std::string& path, size_t frameBytes) {
+    frameBytes_ = frameBytes;
+    if (path == "-") {
+        f_ = stdin;
+        ownsFile_ = false;
+        return true;
+    }
+    f_ = std::fopen(path.c_str(), "rb");
+    ownsFile_ = f_ != nullptr;
+    return f_ != nullptr;
+}
+
+bool LARawFrameReader::next(std::vector<uint8_t>& buf) {
+    if (!f_) return false;
+    buf.resize(frameBytes_);
+    return std::fread(buf.data(), 1, frameBytes_, f_) == frameBytes_;
+}
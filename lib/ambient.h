@@ -0,0 +1,88 @@
+// LegionAura/lib/ambient.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+#include "animation.h"
+
+// ------------------------------------------------------
+// Ambient (screen color) mode.
+// A frame is split into 4 vertical strips, left to right, matching the
+// keyboard zones; each strip is reduced to one color.
+// ------------------------------------------------------
+enum class LAPixelFormat { RGB24, BGRA32 };
+
+enum class LAAmbientMode {
+    Average,    // mean color of the strip
+    Dominant    // most common color (4 bits per channel buckets), averaged within its bucket
+};
+
+// Average-mode kernels. Auto picks the widest one the CPU supports.
+enum class LAAmbientKernel { Auto, Scalar, SSE2, AVX2 };
+
+// A full-frame average is bound by memory bandwidth (33 MB per 4K BGRA
+// frame), and a quarter of the screen averages out the same from a few
+// hundred rows, so by default only this many rows are read.
+constexpr int LA_AMBIENT_ROWS = 540;
+
+struct LAAmbientOptions {
+    LAAmbientMode mode = LAAmbientMode::Average;
+    int xStep = 1;     // sample every Nth pixel of a row (>1 uses the scalar path)
+    int yStep = 0;     // sample every Nth row; 0 = about LA_AMBIENT_ROWS rows per frame
+    LAAmbientKernel kernel = LAAmbientKernel::Auto;
+};
+
+class LAAmbientReducer {
+public:
+    // rowBytes 0 means tightly packed rows.
+    LAAmbientReducer(int width, int height, LAPixelFormat fmt, size_t rowBytes = 0);
+
+    void setOptions(const LAAmbientOptions& o);
+    const LAAmbientOptions& options() const { return opt_; }
+
+    LAZoneFrame reduce(const uint8_t* frame);
+
+    size_t frameBytes() const { return rowBytes_ * (size_t)height_; }
+    LAAmbientKernel kernel() const { return kernel_; }   // resolved, never Auto
+
+    static bool kernelAvailable(LAAmbientKernel k);
+    static const char* kernelName(LAAmbientKernel k);
+
+private:
+    LAZoneFrame reduceAverage(const uint8_t* frame);
+    LAZoneFrame reduceDominant(const uint8_t* frame);
+
+    int width_, height_;
+    LAPixelFormat fmt_;
+    size_t bpp_, rowBytes_;
+    LAAmbientOptions opt_;
+    LAAmbientKernel kernel_ = LAAmbientKernel::Scalar;
+    std::array<int,5> zoneX_{};             // strip edges in pixels
+    std::vector<uint32_t> bucketCount_;     // Dominant: 4096 buckets per zone
+    std::vector<uint32_t> bucketSum_;       // ... and 3 channel sums per bucket
+};
+
+// ------------------------------------------------------
+// Reads fixed-size raw frames, e.g.
+//   ffmpeg -f x11grab -r 30 -s 1920x1080 -i :0 -pix_fmt bgra -f rawvideo -
+// path "-" is stdin.
+// ------------------------------------------------------
+class LARawFrameReader {
+public:
+    LARawFrameReader() = default;
+    ~LARawFrameReader();
+    LARawFrameReader(const LARawFrameReader&) = delete;
+    LARawFrameReader& operator=(const LARawFrameReader&) = delete;
+
+    bool open(const std::string& path, size_t frameBytes);
+    // Fills buf with the next whole frame; false at EOF.
+    bool next(std::vector<uint8_t>& buf);
+
+private:
+    FILE* f_ = nullptr;
+    bool ownsFile_ = false;
+    size_t frameBytes_ = 0;
+};
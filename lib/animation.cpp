@@ -0,0 +1,127 @@
+// /LegionAura/lib/animation.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "animation.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double usBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+LAAnimator::LAAnimator(LARenderFn render, double fps) : render_(std::move(render)) {
+    setFps(fps);
+}
+
+void LAAnimator::setFps(double fps) {
+    fps_ = std::max(0.1, std::min(1000.0, fps));
+}
+
+LAAnimStats LAAnimator::run(LegionAura& kb, double durationSec) {
+    return run([&kb](const LAParams& p){ return kb.apply(p); }, durationSec);
+}
+
+LAAnimStats LAAnimator::run(const LAFrameSink& sink, double durationSec) {
+    LAAnimStats st;
+    stop_.store(false);
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double>(1.0 / fps_));
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(durationSec));
+
+    LAParams p{LAEffect::Static, 1, brightness_, {}, LAWaveDir::None};
+    double jitterSum = 0, sendSum = 0;
+    uint64_t n = 0;
+
+    while (!stop_.load()) {
+        auto deadline = start + period * (long long)n;
+        if (durationSec > 0 && deadline >= end) break;
+
+        std::this_thread::sleep_until(deadline);
+        auto woke = Clock::now();
+
+        // Late by a full period or more: skip to the newest slot we can still hit
+        uint64_t behind = woke > deadline ? (uint64_t)((woke - deadline) / period) : 0;
+        if (behind > 0) {
+            st.framesDropped += behind;
+            n += behind;
+            deadline = start + period * (long long)n;
+        }
+
+        double jitter = usBetween(deadline, woke);
+        jitterSum += jitter;
+        st.jitterMaxUs = std::max(st.jitterMaxUs, jitter);
+
+        p.zones = render_(std::chrono::duration<double>(deadline - start).count(), n);
+
+        auto t0 = Clock::now();
+        bool ok = sink(p);
+        double sendUs = usBetween(t0, Clock::now());
+        sendSum += sendUs;
+        st.sendMaxUs = std::max(st.sendMaxUs, sendUs);
+
+        if (ok) st.framesSent++;
+        else    st.sendFailures++;
+        n++;
+    }
+
+    uint64_t attempts = st.framesSent + st.sendFailures;
+    st.elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+    if (attempts) {
+        st.jitterMeanUs = jitterSum / attempts;
+        st.sendMeanUs   = sendSum / attempts;
+    }
+    if (st.elapsedSec > 0) st.achievedFps = st.framesSent / st.elapsedSec;
+    return st;
+}
+
+// GENERATORS -------------------------------------------------------
+
+LAColor LAAnimator::lerp(LAColor a, LAColor b, double t) {
+    t = std::max(0.0, std::min(1.0, t));
+    auto mix = [t](uint8_t x, uint8_t y){ return (uint8_t)std::lround(x + (y - x) * t); };
+    return LAColor{mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b)};
+}
+
+LARenderFn LAAnimator::paletteWave(std::vector<LAColor> palette, double periodSec) {
+    if (palette.empty()) palette.push_back(LAColor{255,255,255});
+    return [palette, periodSec](double t, uint64_t) {
+        LAZoneFrame f;
+        const double n = (double)palette.size();
+        for (int z = 0; z < 4; ++z) {
+            // position along the palette: time scroll + spatial offset per zone
+            double pos = std::fmod(t / periodSec * n + z * n / 4.0, n);
+            size_t i = (size_t)pos;
+            f[z] = lerp(palette[i], palette[(i + 1) % palette.size()], pos - i);
+        }
+        return f;
+    };
+}
+
+LARenderFn LAAnimator::pulse(LAZoneFrame colors, double periodSec) {
+    return [colors, periodSec](double t, uint64_t) {
+        LAZoneFrame f;
+        for (int z = 0; z < 4; ++z) {
+            double phase = t / periodSec + z * 0.25;
+            double level = 0.5 - 0.5 * std::cos(2.0 * M_PI * phase);
+            f[z] = lerp(LAColor{0,0,0}, colors[z], level);
+        }
+        return f;
+    };
+}
+
+LARenderFn LAAnimator::gradient(LAColor a, LAColor b, double periodSec) {
+    return [a, b, periodSec](double t, uint64_t) {
+        LAZoneFrame f;
+        double shift = 0.5 - 0.5 * std::cos(2.0 * M_PI * t / periodSec);
+        for (int z = 0; z < 4; ++z)
+            f[z] = lerp(a, b, z / 3.0 * (1.0 - shift) + (1.0 - z / 3.0) * shift);
+        return f;
+    };
+}
@@ -0,0 +1,69 @@
+// LegionAura/lib/animation.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "legionaura.h"
+
+using LAZoneFrame = std::array<LAColor,4>;
+
+// Produces the 4 zone colors for frame number `frame` at time `t` (seconds
+// since the animation started). Called on the animation thread.
+using LARenderFn = std::function<LAZoneFrame(double t, uint64_t frame)>;
+
+// Where finished frames go: LegionAura::apply, a daemon client, ...
+using LAFrameSink = std::function<bool(const LAParams&)>;
+
+struct LAAnimStats {
+    uint64_t framesSent    = 0;
+    uint64_t framesDropped = 0;   // deadlines skipped because we were late
+    uint64_t sendFailures  = 0;
+    double   elapsedSec    = 0;
+    double   achievedFps   = 0;
+    double   jitterMeanUs  = 0;   // wake-up time minus deadline
+    double   jitterMaxUs   = 0;
+    double   sendMeanUs    = 0;   // time spent inside the sink per frame
+    double   sendMaxUs     = 0;
+};
+
+// ------------------------------------------------------
+// Host-side animation engine.
+// Renders frames on the host and sends them as Static packets on an
+// absolute-deadline schedule (start + n/fps), so timing errors do not
+// accumulate. When a frame misses its deadline by a full period the
+// missed slots are dropped rather than sent late.
+// ------------------------------------------------------
+class LAAnimator {
+public:
+    explicit LAAnimator(LARenderFn render, double fps = 30.0);
+
+    void setFps(double fps);
+    void setBrightness(uint8_t level) { brightness_ = level; }
+
+    // Runs until durationSec has elapsed (<= 0: until stop()).
+    LAAnimStats run(LegionAura& kb, double durationSec);
+    LAAnimStats run(const LAFrameSink& sink, double durationSec);
+
+    // Safe to call from another thread or a signal handler.
+    void stop() { stop_.store(true); }
+
+    // ----------------------------------------------------
+    // Built-in generators
+    // ----------------------------------------------------
+    // Palette scrolls across the zones, one full cycle per period.
+    static LARenderFn paletteWave(std::vector<LAColor> palette, double periodSec);
+    // Each zone pulses its own color, phase-shifted by a quarter period per zone.
+    static LARenderFn pulse(LAZoneFrame colors, double periodSec);
+    // Gradient from a to b across the zones, sliding back and forth.
+    static LARenderFn gradient(LAColor a, LAColor b, double periodSec);
+
+    static LAColor lerp(LAColor a, LAColor b, double t);
+
+private:
+    LARenderFn render_;
+    double fps_;
+    uint8_t brightness_ = 2;
+    std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,124 @@
+// /LegionAura/lib/async_transfer.cpp
+
+#include <chrono>
+#include <cstring>
+#include <sys/time.h>
+
+#include "async_transfer.h"
+
+LAAsyncEngine::LAAsyncEngine(libusb_context* ctx, libusb_device_handle* dev, size_t poolSize)
+    : ctx_(ctx), dev_(dev), slots_(poolSize)
+{
+    for (auto& s : slots_) {
+        s.xfer = libusb_alloc_transfer(0);
+        s.owner = this;
+        if (s.xfer) free_.push_back(&s);
+    }
+    thread_ = std::thread(&LAAsyncEngine::eventLoop, this);
+}
+
+LAAsyncEngine::~LAAsyncEngine() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (auto& s : slots_)
+            if (s.busy) libusb_cancel_transfer(s.xfer);
+    }
+
+    running_.store(false);
+    cv_.notify_all();
+    libusb_interrupt_event_handler(ctx_);
+    thread_.join();
+
+    // Cancelled transfers still complete through the event loop, and a
+    // submitted transfer must never be freed: keep handling events here
+    // until every slot has come back.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (busyCount() && std::chrono::steady_clock::now() < deadline) {
+        timeval tv{0, 100 * 1000};
+        libusb_handle_events_timeout_completed(ctx_, &tv, nullptr);
+    }
+
+    // A device that never answers the cancel: leak its slots rather than
+    // free memory libusb still owns. Nobody handles events for them any
+    // more, but if someone does, the completion lands in a no-op.
+    if (busyCount()) {
+        for (auto& s : slots_) {
+            if (!s.busy) continue;
+            s.xfer->callback = &LAAsyncEngine::onOrphaned;
+            s.xfer->user_data = nullptr;
+        }
+        auto* orphans = new std::vector<Slot>();
+        orphans->swap(slots_);   // swap keeps the elements (and buffers) in place
+        for (auto& s : *orphans)
+            if (!s.busy && s.xfer) libusb_free_transfer(s.xfer);
+        return;
+    }
+
+    for (auto& s : slots_)
+        if (s.xfer) libusb_free_transfer(s.xfer);
+}
+
+size_t LAAsyncEngine::busyCount() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return inFlight_;
+}
+
+void LIBUSB_CALL LAAsyncEngine::onOrphaned(libusb_transfer*) {}
+
+bool LAAsyncEngine::submit(const uint8_t* data, size_t len, LACompletion done) {
+    if (len > kMaxPayload) return false;
+
+    Slot* s = nullptr;
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cv_.wait(lk, [&]{ return !free_.empty() || !running_.load(); });
+        if (!running_.load()) return false;
+        s = free_.back();
+        free_.pop_back();
+        s->busy = true;
+        inFlight_++;
+    }
+
+    // Same request as ctrlSendCC: class/interface SET_REPORT, feature report 0xCC
+    libusb_fill_control_setup(s->buf.data(), 0x21, 0x09, 0x03CC, 0x00, (uint16_t)len);
+    std::memcpy(s->buf.data() + LIBUSB_CONTROL_SETUP_SIZE, data, len);
+    s->len = len;
+    s->done = std::move(done);
+    libusb_fill_control_transfer(s->xfer, dev_, s->buf.data(), &LAAsyncEngine::onComplete, s, 1000);
+
+    if (libusb_submit_transfer(s->xfer) != 0) {
+        LACompletion cb = std::move(s->done);
+        release(s);
+        if (cb) cb(false);
+        return false;
+    }
+    return true;
+}
+
+void LIBUSB_CALL LAAsyncEngine::onComplete(libusb_transfer* t) {
+    auto* s = static_cast<Slot*>(t->user_data);
+    bool ok = t->status == LIBUSB_TRANSFER_COMPLETED && t->actual_length == (int)s->len;
+
+    // Free the slot first so the callback may immediately submit again
+    LACompletion cb = std::move(s->done);
+    s->owner->release(s);
+    if (cb) cb(ok);
+}
+
+void LAAsyncEngine::release(Slot* s) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        s->done = nullptr;
+        s->busy = false;
+        free_.push_back(s);
+        inFlight_--;
+    }
+    cv_.notify_all();
+}
+
+void LAAsyncEngine::eventLoop() {
+    while (running_.load()) {
+        timeval tv{0, 100 * 1000};
+        libusb_handle_events_timeout_completed(ctx_, &tv, nullptr);
+    }
+}
@@ -0,0 +1,59 @@
+// LegionAura/lib/async_transfer.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <libusb-1.0/libusb.h>
+
+using LACompletion = std::function<void(bool ok)>;
+
+// ------------------------------------------------------
+// SET_REPORT submission on libusb's async API.
+// A fixed pool of libusb_transfer objects with their setup+data buffers
+// is allocated up front; a dedicated thread runs the libusb event loop
+// and fires completions. Callbacks run on that event thread.
+// ------------------------------------------------------
+class LAAsyncEngine {
+public:
+    static constexpr size_t kMaxPayload = 32;
+
+    LAAsyncEngine(libusb_context* ctx, libusb_device_handle* dev, size_t poolSize = 8);
+    ~LAAsyncEngine();   // cancels in-flight transfers and waits for them to come back
+
+    LAAsyncEngine(const LAAsyncEngine&) = delete;
+    LAAsyncEngine& operator=(const LAAsyncEngine&) = delete;
+
+    // Blocks only while every pool slot is in flight.
+    bool submit(const uint8_t* data, size_t len, LACompletion done);
+
+private:
+    struct Slot {
+        libusb_transfer* xfer = nullptr;
+        std::array<unsigned char, LIBUSB_CONTROL_SETUP_SIZE + kMaxPayload> buf{};
+        size_t len = 0;
+        LACompletion done;
+        bool busy = false;
+        LAAsyncEngine* owner = nullptr;
+    };
+
+    static void LIBUSB_CALL onComplete(libusb_transfer* t);
+    static void LIBUSB_CALL onOrphaned(libusb_transfer* t);
+    size_t busyCount();
+    void eventLoop();
+    void release(Slot* s);
+
+    libusb_context* ctx_;
+    libusb_device_handle* dev_;
+    std::vector<Slot> slots_;
+    std::vector<Slot*> free_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    size_t inFlight_ = 0;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
@@ -0,0 +1,305 @@
+// /LegionAura/lib/audio.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "audio.h"
+#include "io_stats.h"
+
+using Clock = std::chrono::steady_clock;
+
+// PCM READER -------------------------------------------------------
+
+LAPcmReader::~LAPcmReader() {
+    if (f_ && ownsFile_) std::fclose(f_);
+}
+
+static uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+bool LAPcmReader::open(const std::string& path, const LAPcmFormat& rawFormat) {
+    if (path == "-") {
+        f_ = stdin;
+        ownsFile_ = false;
+    } else {
+        f_ = std::fopen(path.c_str(), "rb");
+        if (!f_) return false;
+        ownsFile_ = true;
+    }
+    fmt_ = rawFormat;
+
+    // Probe for a RIFF/WAVE header without seeking (stdin may be a pipe)
+    uint8_t hdr[12];
+    size_t got = std::fread(hdr, 1, sizeof(hdr), f_);
+    if (got == sizeof(hdr) && !std::memcmp(hdr, "RIFF", 4) && !std::memcmp(hdr + 8, "WAVE", 4)) {
+        wav_ = true;
+        return parseWavHeader();
+    }
+    pending_.assign(hdr, hdr + got);
+    return true;
+}
+
+bool LAPcmReader::parseWavHeader() {
+    bool haveFmt = false;
+    uint8_t ch[8];
+    while (std::fread(ch, 1, 8, f_) == 8) {
+        uint32_t size = le32(ch + 4);
+
+        if (!std::memcmp(ch, "fmt ", 4)) {
+            // 16 (PCM), 18 (cbSize) or 40 (EXTENSIBLE) in practice; the size
+            // comes from the file, so don't let it pick an allocation
+            uint8_t b[64];
+            if (size < 16 || size > sizeof(b) || std::fread(b, 1, size, f_) != size) return false;
+            uint16_t tag = le16(&b[0]);
+            if (tag == 0xFFFE && size >= 26) tag = le16(&b[24]);   // WAVE_FORMAT_EXTENSIBLE
+            uint16_t bits = le16(&b[14]);
+
+            fmt_.channels = le16(&b[2]);
+            fmt_.sampleRate = le32(&b[4]);
+            if (tag == 1 && bits == 16) fmt_.format = LASampleFormat::S16LE;
+            else if (tag == 3 && bits == 32) fmt_.format = LASampleFormat::F32LE;
+            else return false;   // only 16-bit PCM and 32-bit float
+            if (fmt_.channels == 0 || fmt_.sampleRate == 0) return false;
+            haveFmt = true;
+            if (size & 1) std::fgetc(f_);
+        } else if (!std::memcmp(ch, "data", 4)) {
+            // Streaming writers leave the size at 0 or 0xFFFFFFFF
+            dataLeft_ = (size == 0 || size == 0xFFFFFFFFu) ? UINT64_MAX : size;
+            return haveFmt;
+        } else {
+            for (uint32_t k = 0; k < size + (size & 1); ++k)
+                if (std::fgetc(f_) == EOF) return false;
+        }
+    }
+    return false;
+}
+
+size_t LAPcmReader::readBytes(uint8_t* dst, size_t n) {
+    size_t done = 0;
+    if (!pending_.empty()) {
+        done = std::min(n, pending_.size());
+        std::memcpy(dst, pending_.data(), done);
+        pending_.erase(pending_.begin(), pending_.begin() + done);
+    }
+    size_t want = (size_t)std::min<uint64_t>(n - done, dataLeft_);
+    size_t got = want ? std::fread(dst + done, 1, want, f_) : 0;
+    if (dataLeft_ != UINT64_MAX) dataLeft_ -= got;
+    return done + got;
+}
+
+size_t LAPcmReader::read(float* mono, size_t n) {
+    if (!f_) return 0;
+
+    const size_t sampleBytes = fmt_.format == LASampleFormat::S16LE ? 2 : 4;
+    const size_t frameBytes = sampleBytes * fmt_.channels;
+    raw_.resize(n * frameBytes);
+
+    size_t frames = readBytes(raw_.data(), raw_.size()) / frameBytes;
+    const float scale = 1.0f / fmt_.channels;
+
+    for (size_t i = 0; i < frames; ++i) {
+        const uint8_t* p = raw_.data() + i * frameBytes;
+        float acc = 0;
+        for (uint16_t c = 0; c < fmt_.channels; ++c, p += sampleBytes) {
+            if (fmt_.format == LASampleFormat::S16LE) {
+                acc += (int16_t)le16(p) * (1.0f / 32768.0f);
+            } else {
+                float v;
+                std::memcpy(&v, p, 4);
+                acc += v;
+            }
+        }
+        mono[i] = acc * scale;
+    }
+    return frames;
+}
+
+// ANALYZER ---------------------------------------------------------
+
+LAAudioAnalyzer::LAAudioAnalyzer(uint32_t sampleRate, size_t fftSize)
+    : rate_(sampleRate), n_(fftSize)
+{
+    if (n_ < 16 || (n_ & (n_ - 1))) n_ = 1024;
+
+    window_.resize(n_);
+    for (size_t i = 0; i < n_; ++i)
+        window_[i] = 0.5f - 0.5f * std::cos(2.0 * M_PI * i / (n_ - 1));
+
+    history_.assign(n_, 0.f);
+    re_.resize(n_);
+    im_.resize(n_);
+
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < n_) bits++;
+    bitrev_.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+        uint32_t r = 0;
+        for (unsigned b = 0; b < bits; ++b) if (i & (size_t(1) << b)) r |= 1u << (bits - 1 - b);
+        bitrev_[i] = r;
+    }
+
+    // Twiddles stored stage by stage so each butterfly loop reads them contiguously
+    for (size_t size = 2; size <= n_; size *= 2) {
+        for (size_t k = 0; k < size / 2; ++k) {
+            double a = -2.0 * M_PI * k / size;
+            twRe_.push_back((float)std::cos(a));
+            twIm_.push_back((float)std::sin(a));
+        }
+    }
+
+    updateBins();
+}
+
+void LAAudioAnalyzer::setSmoothing(float attackMs, float decayMs) {
+    attackMs_ = std::max(0.1f, attackMs);
+    decayMs_ = std::max(0.1f, decayMs);
+}
+
+void LAAudioAnalyzer::setBandEdges(const std::array<float,5>& hz) {
+    edgesHz_ = hz;
+    updateBins();
+}
+
+void LAAudioAnalyzer::setRangeDb(float floorDb, float ceilDb) {
+    floorDb_ = floorDb;
+    ceilDb_ = std::max(floorDb + 1.f, ceilDb);
+}
+
+void LAAudioAnalyzer::updateBins() {
+    const double binHz = (double)rate_ / n_;
+    for (size_t e = 0; e < 5; ++e) {
+        size_t b = (size_t)std::lround(edgesHz_[e] / binHz);
+        edgeBin_[e] = std::min(n_ / 2, std::max<size_t>(1, b));
+    }
+    for (size_t e = 1; e < 5; ++e)
+        edgeBin_[e] = std::max(edgeBin_[e], edgeBin_[e - 1] + 1);
+}
+
+void LAAudioAnalyzer::fft() {
+    for (size_t i = 0; i < n_; ++i) {
+        size_t j = bitrev_[i];
+        if (j > i) { std::swap(re_[i], re_[j]); std::swap(im_[i], im_[j]); }
+    }
+
+    float* re = re_.data();
+    float* im = im_.data();
+    const float* twr = twRe_.data();
+    const float* twi = twIm_.data();
+
+    for (size_t half = 1; half < n_; half *= 2) {
+        for (size_t start = 0; start < n_; start += 2 * half) {
+            float* ar = re + start;      float* ai = im + start;
+            float* br = ar + half;       float* bi = ai + half;
+            for (size_t k = 0; k < half; ++k) {
+                float tr = br[k] * twr[k] - bi[k] * twi[k];
+                float ti = br[k] * twi[k] + bi[k] * twr[k];
+                br[k] = ar[k] - tr;  bi[k] = ai[k] - ti;
+                ar[k] = ar[k] + tr;  ai[k] = ai[k] + ti;
+            }
+        }
+        twr += half;
+        twi += half;
+    }
+}
+
+std::array<float,4> LAAudioAnalyzer::process(const float* mono, size_t n) {
+    // Slide the analysis window
+    if (n >= n_) {
+        std::memcpy(history_.data(), mono + (n - n_), n_ * sizeof(float));
+    } else if (n > 0) {
+        std::memmove(history_.data(), history_.data() + n, (n_ - n) * sizeof(float));
+        std::memcpy(history_.data() + (n_ - n), mono, n * sizeof(float));
+    }
+    sincePush_ += n;
+
+    const float* h = history_.data();
+    const float* w = window_.data();
+    float* re = re_.data();
+    for (size_t i = 0; i < n_; ++i) re[i] = h[i] * w[i];
+    std::fill(im_.begin(), im_.end(), 0.f);
+
+    fft();
+
+    // Reference: a full-scale sine puts about (n/4)^2 into its Hann-windowed peak bin
+    const float ref = (float)(n_ / 4) * (float)(n_ / 4);
+    const double hopSec = (double)sincePush_ / rate_;
+    sincePush_ = 0;
+    const float a = (float)std::exp(-hopSec * 1000.0 / attackMs_);
+    const float d = (float)std::exp(-hopSec * 1000.0 / decayMs_);
+
+    for (size_t b = 0; b < 4; ++b) {
+        float power = 0;
+        const float* r = re_.data();
+        const float* im = im_.data();
+        for (size_t k = edgeBin_[b]; k < edgeBin_[b + 1]; ++k)
+            power += r[k] * r[k] + im[k] * im[k];
+
+        float db = 10.f * std::log10(power / ref + 1e-12f);
+        float target = std::min(1.f, std::max(0.f, (db - floorDb_) / (ceilDb_ - floorDb_)));
+
+        float coef = target > level_[b] ? a : d;
+        level_[b] = target + (level_[b] - target) * coef;
+    }
+    return level_;
+}
+
+// RUNNER -----------------------------------------------------------
+
+LAAudioStats LAAudioReactive::run(const LAFrameSink& sink) {
+    LAAudioStats st;
+    stop_.store(false);
+
+    const uint32_t rate = in_.format().sampleRate;
+    const size_t hop = std::max<size_t>(1, (size_t)std::lround(rate / std::max(1.0, fps_)));
+    std::vector<float> buf(hop);
+    LALatencyHistogram latency;   // fixed size, however long the stream runs
+
+    LAParams p{LAEffect::Static, 1, brightness_, {}, LAWaveDir::None};
+    double dspSum = 0, latSum = 0;
+    uint64_t samples = 0;
+    const auto start = Clock::now();
+
+    while (!stop_.load()) {
+        size_t n = in_.read(buf.data(), hop);
+        if (n == 0) break;
+        samples += n;
+
+        // Files arrive instantly; release each block when it would have been captured
+        if (realtime_)
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>((double)samples / rate)));
+        auto tBlock = Clock::now();
+
+        auto levels = dsp_.process(buf.data(), n);
+        for (int z = 0; z < 4; ++z)
+            p.zones[z] = LAAnimator::lerp(LAColor{0,0,0}, colors_[z], levels[z]);
+
+        auto tDsp = Clock::now();
+        bool ok = sink(p);
+        auto tSent = Clock::now();
+
+        double dspUs = std::chrono::duration<double, std::micro>(tDsp - tBlock).count();
+        double latUs = std::chrono::duration<double, std::micro>(tSent - tBlock).count();
+        dspSum += dspUs;
+        latSum += latUs;
+        st.dspMaxUs = std::max(st.dspMaxUs, dspUs);
+        st.latencyMaxUs = std::max(st.latencyMaxUs, latUs);
+        latency.add((uint64_t)latUs);
+
+        if (ok) st.frames++;
+        else    st.sendFailures++;
+    }
+
+    const uint64_t hops = latency.count;
+    st.audioSec = (double)samples / rate;
+    if (hops) {
+        st.dspMeanUs = dspSum / hops;
+        st.latencyMeanUs = latSum / hops;
+        st.latencyP99Us = latency.percentileUs(0.99);
+    }
+    if (st.audioSec > 0) st.cpuFraction = dspSum / 1e6 / st.audioSec;
+    return st;
+}
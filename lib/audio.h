@@ -0,0 +1,126 @@
+// LegionAura/lib/audio.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+#include "animation.h"
+
+// ------------------------------------------------------
+// PCM input: a WAV file/stream (16-bit PCM or 32-bit float, detected
+// from the RIFF header) or headerless interleaved samples, e.g.
+//   parec --raw --format=s16le --rate=48000 --channels=2 | legionaura audio -
+// Frames are downmixed to mono float in [-1, 1].
+// ------------------------------------------------------
+enum class LASampleFormat { S16LE, F32LE };
+
+struct LAPcmFormat {
+    uint32_t sampleRate = 48000;
+    uint16_t channels = 2;
+    LASampleFormat format = LASampleFormat::S16LE;
+};
+
+class LAPcmReader {
+public:
+    LAPcmReader() = default;
+    ~LAPcmReader();
+    LAPcmReader(const LAPcmReader&) = delete;
+    LAPcmReader& operator=(const LAPcmReader&) = delete;
+
+    // path "-" is stdin. rawFormat is used when there is no RIFF header.
+    bool open(const std::string& path, const LAPcmFormat& rawFormat);
+    const LAPcmFormat& format() const { return fmt_; }
+    bool isWav() const { return wav_; }
+
+    // Reads up to n mono frames; returns how many were read (0 at EOF).
+    size_t read(float* mono, size_t n);
+
+private:
+    bool parseWavHeader();
+    size_t readBytes(uint8_t* dst, size_t n);
+
+    FILE* f_ = nullptr;
+    bool ownsFile_ = false;
+    bool wav_ = false;
+    LAPcmFormat fmt_;
+    uint64_t dataLeft_ = UINT64_MAX;   // bytes left in the WAV data chunk
+    std::vector<uint8_t> pending_;     // bytes peeked while probing for a header
+    std::vector<uint8_t> raw_;
+};
+
+// ------------------------------------------------------
+// Windowed FFT -> 4 band levels (bass .. treble) with attack/decay.
+// Data is kept as separate real/imag float arrays and every stage is a
+// straight loop over contiguous memory so the compiler can vectorize the
+// window, butterflies and power sums. Twiddles, bit-reversal and band
+// bin ranges are computed once.
+// ------------------------------------------------------
+class LAAudioAnalyzer {
+public:
+    // fftSize must be a power of two.
+    LAAudioAnalyzer(uint32_t sampleRate, size_t fftSize = 1024);
+
+    void setSmoothing(float attackMs, float decayMs);
+    void setBandEdges(const std::array<float,5>& hz);   // 4 bands, 5 edges
+    void setRangeDb(float floorDb, float ceilDb);
+
+    // Push new samples (any count) and return the smoothed levels 0..1
+    // computed over the most recent fftSize samples.
+    std::array<float,4> process(const float* mono, size_t n);
+
+    size_t fftSize() const { return n_; }
+
+private:
+    void fft();
+    void updateBins();
+
+    uint32_t rate_;
+    size_t n_;
+    std::vector<float> window_, history_, re_, im_, twRe_, twIm_;
+    std::vector<uint32_t> bitrev_;
+    std::array<float,5> edgesHz_{20.f, 250.f, 1000.f, 4000.f, 16000.f};
+    std::array<size_t,5> edgeBin_{};
+    float floorDb_ = -70.f, ceilDb_ = -10.f;
+    float attackMs_ = 10.f, decayMs_ = 180.f;
+    std::array<float,4> level_{};
+    size_t sincePush_ = 0;   // samples since the last process() call
+};
+
+struct LAAudioStats {
+    uint64_t frames = 0;        // lighting frames sent
+    uint64_t sendFailures = 0;
+    double   audioSec = 0;      // audio consumed
+    double   dspMeanUs = 0, dspMaxUs = 0;
+    double   latencyMeanUs = 0, latencyP99Us = 0, latencyMaxUs = 0;  // block complete -> sink returned;
+                                                                   // p99 is a log2 bucket bound
+    double   cpuFraction = 0;   // DSP time / audio time
+};
+
+// ------------------------------------------------------
+// Reads PCM in hops of sampleRate/fps frames, analyzes each hop and
+// sends one Static frame per hop, zone i = colors[i] scaled by band i.
+// ------------------------------------------------------
+class LAAudioReactive {
+public:
+    LAAudioReactive(LAPcmReader& in, LAAudioAnalyzer& dsp) : in_(in), dsp_(dsp) {}
+
+    void setFps(double fps) { fps_ = fps; }
+    void setColors(const LAZoneFrame& c) { colors_ = c; }
+    void setBrightness(uint8_t b) { brightness_ = b; }
+    void setRealtime(bool on) { realtime_ = on; }   // pace file input to the sample clock
+
+    LAAudioStats run(const LAFrameSink& sink);
+    void stop() { stop_.store(true); }
+
+private:
+    LAPcmReader& in_;
+    LAAudioAnalyzer& dsp_;
+    double fps_ = 60;
+    LAZoneFrame colors_{LAColor{255,0,0}, LAColor{255,160,0}, LAColor{0,255,60}, LAColor{0,120,255}};
+    uint8_t brightness_ = 2;
+    bool realtime_ = false;
+    std::atomic<bool> stop_{false};
+};
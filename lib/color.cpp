@@ -0,0 +1,138 @@
+// /LegionAura/lib/color.cpp
+
+#include <algorithm>
+#include <cmath>
+
+#include "color.h"
+#include "device_table.h"
+
+LAColorProfile LAColorProfile::forDevice(uint16_t vid, uint16_t pid) {
+    LAColorProfile p;
+    if (const LADeviceInfo* d = LADeviceRegistry::instance().find(vid, pid)) {
+        if (d->gamma > 0) p.gamma = d->gamma;
+        for (int c = 0; c < 3; ++c)
+            if (d->whiteBalance[c] > 0) p.whiteBalance[c] = d->whiteBalance[c];
+    }
+    return p;
+}
+
+bool LAColorProfile::isIdentity() const {
+    return gamma == 1.0f && whiteBalance[0] == 1.0f && whiteBalance[1] == 1.0f && whiteBalance[2] == 1.0f;
+}
+
+// ------------------------------------------------------
+
+LAColorPipeline::LAColorPipeline() {
+    rebuild();
+}
+
+LAColorPipeline::LAColorPipeline(const LAColorProfile& profile, float brightness)
+    : profile_(profile), brightness_(std::clamp(brightness, 0.0f, 100.0f))
+{
+    rebuild();
+}
+
+void LAColorPipeline::setProfile(const LAColorProfile& profile) {
+    profile_ = profile;
+    rebuild();
+}
+
+void LAColorPipeline::setBrightness(float percent) {
+    percent = std::clamp(percent, 0.0f, 100.0f);
+    if (percent == brightness_) return;
+    brightness_ = percent;
+    rebuild();
+}
+
+float LAColorPipeline::perceptualScale(float percent) {
+    const double L = std::clamp(percent, 0.0f, 100.0f);
+    if (L > 8.0) {
+        double f = (L + 16.0) / 116.0;
+        return (float)(f * f * f);
+    }
+    return (float)(L / 903.3);
+}
+
+void LAColorPipeline::rebuild() {
+    const double k = perceptualScale(brightness_);
+    const double gamma = profile_.gamma > 0 ? profile_.gamma : 1.0;
+
+    identity_ = profile_.isIdentity() && brightness_ >= 100.0f;
+
+    for (int c = 0; c < 3; ++c) {
+        const double gain = k * profile_.whiteBalance[c];
+        for (int i = 0; i < 256; ++i) {
+            double v = std::pow(i / 255.0, gamma) * gain;
+            lut_[c][i] = (uint8_t)std::lround(std::clamp(v, 0.0, 1.0) * 255.0);
+        }
+    }
+}
+
+void LAColorPipeline::apply(LAParams& p) const {
+    for (auto& z : p.zones) z = apply(z);
+}
+
+void LAColorPipeline::apply(const LAColor* in, LAColor* out, size_t n) const {
+    const uint8_t* r = lut_[0].data();
+    const uint8_t* g = lut_[1].data();
+    const uint8_t* b = lut_[2].data();
+    for (size_t i = 0; i < n; ++i)
+        out[i] = LAColor{r[in[i].r], g[in[i].g], b[in[i].b]};
+}
+
+// OKLAB ------------------------------------------------------------
+
+static float srgbToLinear(uint8_t v) {
+    float c = v / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static uint8_t linearToSrgb(float c) {
+    c = std::clamp(c, 0.0f, 1.0f);
+    float v = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    return (uint8_t)std::lround(v * 255.0f);
+}
+
+LAOklab laToOklab(LAColor c) {
+    const float r = srgbToLinear(c.r), g = srgbToLinear(c.g), b = srgbToLinear(c.b);
+
+    const float l = std::cbrt(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+    const float m = std::cbrt(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+    const float s = std::cbrt(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+
+    return LAOklab{
+        0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+        1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+        0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s
+    };
+}
+
+LAColor laFromOklab(const LAOklab& c) {
+    float l = c.L + 0.3963377774f * c.a + 0.2158037573f * c.b;
+    float m = c.L - 0.1055613458f * c.a - 0.0638541728f * c.b;
+    float s = c.L - 0.0894841775f * c.a - 1.2914855480f * c.b;
+    l = l * l * l; m = m * m * m; s = s * s * s;
+
+    return LAColor{
+        linearToSrgb( 4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s),
+        linearToSrgb(-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s),
+        linearToSrgb(-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s)
+    };
+}
+
+// FADES ------------------------------------------------------------
+
+LAZoneFade::LAZoneFade(const LAParams& from, const LAParams& to)
+    : brightness_(to.brightness)
+{
+    for (int z = 0; z < 4; ++z) {
+        a_[z] = laToOklab(from.zones[z]);
+        b_[z] = laToOklab(to.zones[z]);
+    }
+}
+
+LAParams LAZoneFade::at(float t) const {
+    LAParams frame{LAEffect::Static, 1, brightness_, {}, LAWaveDir::None};
+    for (int z = 0; z < 4; ++z) frame.zones[z] = laFromOklab(laLerp(a_[z], b_[z], t));
+    return frame;
+}
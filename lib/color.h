@@ -0,0 +1,91 @@
+// LegionAura/lib/color.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "legionaura.h"
+
+// ------------------------------------------------------
+// Per-model color correction. gamma is the exponent applied to each
+// channel before it is sent (1 = raw, ~2.2 for LEDs driven linearly);
+// whiteBalance scales R/G/B in linear light so full white looks neutral.
+// Values come from the optional "gamma" and "whiteBalance" keys of a
+// devices.json entry.
+// ------------------------------------------------------
+struct LAColorProfile {
+    float gamma = 1.0f;
+    std::array<float,3> whiteBalance{1.0f, 1.0f, 1.0f};
+
+    static LAColorProfile forDevice(uint16_t vid, uint16_t pid);   // identity if unknown
+    bool isIdentity() const;
+};
+
+// ------------------------------------------------------
+// Color stage between LAParams and the packet encoder: profile plus a
+// continuous 0..100% software brightness, folded into one 256-entry
+// table per channel. Tables are rebuilt only when a setting changes, so
+// converting a color is three lookups.
+// Brightness is perceptual: the percentage is CIE L*, so 50% looks half
+// as bright rather than being half the LED current.
+// ------------------------------------------------------
+class LAColorPipeline {
+public:
+    LAColorPipeline();
+    explicit LAColorPipeline(const LAColorProfile& profile, float brightness = 100.0f);
+
+    void setProfile(const LAColorProfile& profile);
+    void setBrightness(float percent);
+    const LAColorProfile& profile() const { return profile_; }
+    float brightness() const { return brightness_; }
+    bool isIdentity() const { return identity_; }
+
+    LAColor apply(LAColor c) const { return LAColor{lut_[0][c.r], lut_[1][c.g], lut_[2][c.b]}; }
+    void apply(LAParams& p) const;                                  // zones in place
+    void apply(const LAColor* in, LAColor* out, size_t n) const;    // batch, in may equal out
+
+    const std::array<uint8_t,256>& table(int channel) const { return lut_[channel]; }
+
+    static float perceptualScale(float percent);   // CIE L* (0..100) -> linear factor
+
+private:
+    void rebuild();
+
+    LAColorProfile profile_;
+    float brightness_ = 100.0f;
+    bool identity_ = true;
+    std::array<std::array<uint8_t,256>,3> lut_;
+};
+
+// ------------------------------------------------------
+// OKLab (Björn Ottosson, 2020): a perceptual space where straight-line
+// interpolation looks even, so fades do not dip through muddy or dark
+// midpoints the way RGB lerps do. Inputs/outputs are 8-bit sRGB.
+// ------------------------------------------------------
+struct LAOklab { float L, a, b; };
+
+LAOklab laToOklab(LAColor c);
+LAColor laFromOklab(const LAOklab& c);   // out-of-gamut results are clipped
+
+// Straight line from a (t = 0) to b (t = 1)
+constexpr LAOklab laLerp(const LAOklab& a, const LAOklab& b, float t) {
+    return LAOklab{a.L + (b.L - a.L) * t, a.a + (b.a - a.a) * t, a.b + (b.b - a.b) * t};
+}
+
+// ------------------------------------------------------
+// The frames of a fade between two lighting states, as sent by
+// LegionAura::transition and rendered by the timeline compiler. Both
+// ends must carry zone colors (canFade). Each frame is Static with the
+// target's brightness and every zone interpolated in OKLab; callers
+// finish with the target itself, which may be Breath.
+// ------------------------------------------------------
+class LAZoneFade {
+public:
+    static constexpr bool canFade(LAEffect e) { return e == LAEffect::Static || e == LAEffect::Breath; }
+
+    LAZoneFade(const LAParams& from, const LAParams& to);
+    LAParams at(float t) const;   // t: 0..1
+
+private:
+    std::array<LAOklab,4> a_, b_;
+    uint8_t brightness_;
+};
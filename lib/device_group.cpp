@@ -0,0 +1,121 @@
+// /LegionAura/lib/device_group.cpp
+
+#include <algorithm>
+#include <thread>
+
+#include "device_group.h"
+
+LADeviceGroup::~LADeviceGroup() {
+    close();
+}
+
+size_t LADeviceGroup::openAll() {
+    for (auto& [where, kb] : LegionAura::openEvery()) add(std::move(kb), where);
+    return members_.size();
+}
+
+bool LADeviceGroup::add(uint8_t bus, uint8_t addr) {
+    auto kb = std::make_unique<LegionAura>();
+    if (!kb->openAt(bus, addr)) return false;
+    const LAUsbDevice where{bus, addr, kb->getVid(), kb->getPid()};
+    return add(std::move(kb), where);
+}
+
+bool LADeviceGroup::add(std::unique_ptr<LegionAura> kb, const LAUsbDevice& where) {
+    if (!kb || !kb->isOpen()) return false;
+    kb->setSoftwareBrightness(level_);
+    Member m;
+    m.where = where;
+    m.kb = std::move(kb);
+    m.io = std::make_unique<LAIoThread>(*m.kb);
+    m.st.device = where;
+    members_.push_back(std::move(m));
+    return true;
+}
+
+void LADeviceGroup::close() {
+    for (auto& m : members_) m.io->stop();
+    members_.clear();
+}
+
+// ------------------------------------------------------
+// One frame on every device: queue it on each worker with the same
+// deadline, then collect the results.
+// ------------------------------------------------------
+template <class Op>
+LAGroupFrame LADeviceGroup::run(Op op) {
+    LAGroupFrame f;
+    if (members_.empty()) return f;
+
+    const auto deadline = Clock::now() + lead_;
+    std::vector<std::future<LAGroupDeviceResult>> pending;
+    pending.reserve(members_.size());
+
+    for (auto& m : members_) {
+        pending.push_back(m.io->submit([op, deadline](LegionAura& kb) {
+            std::this_thread::sleep_until(deadline);
+            LAGroupDeviceResult r;
+            r.startUs = std::chrono::duration<double, std::micro>(Clock::now() - deadline).count();
+            r.ok = op(kb);
+            r.doneUs = std::chrono::duration<double, std::micro>(Clock::now() - deadline).count();
+            return r;
+        }));
+    }
+
+    f.ok = true;
+    double first = 0, last = 0;
+    for (size_t i = 0; i < members_.size(); ++i) {
+        LAGroupDeviceResult r = pending[i].get();
+        f.devices.push_back(r);
+        f.ok = f.ok && r.ok;
+        first = i ? std::min(first, r.doneUs) : r.doneUs;
+        last  = i ? std::max(last, r.doneUs)  : r.doneUs;
+
+        LAGroupDeviceStats& st = members_[i].st;
+        st.frames++;
+        if (!r.ok) st.failures++;
+        st.startMeanUs += (r.startUs - st.startMeanUs) / st.frames;
+        st.doneMeanUs  += (r.doneUs - st.doneMeanUs) / st.frames;
+        st.startMaxUs = std::max(st.startMaxUs, r.startUs);
+        st.doneMaxUs  = std::max(st.doneMaxUs, r.doneUs);
+    }
+    f.skewUs = last - first;
+    return f;
+}
+
+LAGroupFrame LADeviceGroup::apply(const LAParams& p) {
+    return run([p](LegionAura& kb){ return kb.apply(p); });
+}
+
+LAGroupFrame LADeviceGroup::off() {
+    return run([](LegionAura& kb){ return kb.off(); });
+}
+
+LAGroupFrame LADeviceGroup::setBrightnessOnly(uint8_t level) {
+    return run([level](LegionAura& kb){ return kb.setBrightnessOnly(level); });
+}
+
+LAGroupFrame LADeviceGroup::sendPacket(const LAPacket& payload) {
+    return run([payload](LegionAura& kb){ return kb.sendPacket(payload); });
+}
+
+LAGroupFrame LADeviceGroup::applyEncoded(const LAPacket& payload) {
+    return run([payload](LegionAura& kb){ return kb.applyEncoded(payload); });
+}
+
+// Every device fades on its own worker from the same start; each one
+// paces itself to its own round trip and all end at the same deadline.
+LAGroupFrame LADeviceGroup::transition(const LAParams& to, std::chrono::milliseconds duration) {
+    return run([to, duration](LegionAura& kb){ return kb.transition(to, duration); });
+}
+
+void LADeviceGroup::setSoftwareBrightness(float percent) {
+    level_ = percent;
+    for (auto& m : members_) m.kb->setSoftwareBrightness(percent);   // guarded by the pipeline's own mutex
+}
+
+std::vector<LAGroupDeviceStats> LADeviceGroup::stats() const {
+    std::vector<LAGroupDeviceStats> out;
+    for (auto& m : members_) out.push_back(m.st);
+    return out;
+}
@@ -0,0 +1,86 @@
+// LegionAura/lib/device_group.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "legionaura.h"
+#include "io_thread.h"
+#include "packet.h"
+
+// Outcome of one frame on one device. Offsets are relative to the
+// frame's shared deadline.
+struct LAGroupDeviceResult {
+    bool ok = false;
+    double startUs = 0;   // transfer started (>= 0 unless the clock was early)
+    double doneUs  = 0;   // transfer finished
+};
+
+struct LAGroupFrame {
+    bool ok = false;                          // every device succeeded
+    std::vector<LAGroupDeviceResult> devices; // same order as the group
+    double skewUs = 0;                        // spread of doneUs across devices
+};
+
+// Running per-device totals
+struct LAGroupDeviceStats {
+    LAUsbDevice device;
+    uint64_t frames = 0;
+    uint64_t failures = 0;
+    double startMeanUs = 0, startMaxUs = 0;   // wake-up lateness vs. the deadline
+    double doneMeanUs  = 0, doneMaxUs  = 0;   // when the device had the frame
+};
+
+// ------------------------------------------------------
+// Several controllers driven in lockstep. Each device gets its own
+// I/O worker (an LAIoThread); a frame is handed to every worker with
+// one shared deadline a little in the future, every worker sleeps
+// until it and then sends, so the transfers start together instead of
+// one after another. Skew is the spread of completion times.
+// ------------------------------------------------------
+class LADeviceGroup {
+public:
+    LADeviceGroup() = default;
+    ~LADeviceGroup();
+
+    size_t openAll();                              // every supported controller, one enumeration
+    bool add(uint8_t bus, uint8_t addr);
+    bool add(std::unique_ptr<LegionAura> kb, const LAUsbDevice& where); // already open (e.g. simulated)
+    void close();
+
+    size_t size() const { return members_.size(); }
+    const LAUsbDevice& device(size_t i) const { return members_[i].where; }
+    LegionAura& at(size_t i) { return *members_[i].kb; }   // only while no frame is in flight
+
+    // How far ahead of "now" a frame's deadline is set. Long enough for
+    // every worker to be woken and parked on the deadline.
+    void setLead(std::chrono::microseconds lead) { lead_ = lead; }
+
+    LAGroupFrame apply(const LAParams& p);
+    LAGroupFrame off();
+    LAGroupFrame setBrightnessOnly(uint8_t level);
+    LAGroupFrame sendPacket(const LAPacket& payload);   // pre-encoded, as LegionAura::sendPacket
+    LAGroupFrame applyEncoded(const LAPacket& payload); // as LegionAura::applyEncoded
+    LAGroupFrame transition(const LAParams& to, std::chrono::milliseconds duration);
+    // Applies to every member, including ones added later
+    void setSoftwareBrightness(float percent);
+
+    std::vector<LAGroupDeviceStats> stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Member {
+        LAUsbDevice where;
+        std::unique_ptr<LegionAura> kb;
+        std::unique_ptr<LAIoThread> io;
+        LAGroupDeviceStats st;
+    };
+
+    template <class Op>
+    LAGroupFrame run(Op op);
+
+    std::vector<Member> members_;
+    std::chrono::microseconds lead_{2000};
+    float level_ = 100.f;
+};
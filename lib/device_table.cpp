@@ -0,0 +1,180 @@
+// /LegionAura/lib/device_table.cpp
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "device_table.h"
+
+// ------------------------------------------------------
+// Minimal JSON scanner: strings, numbers and structure only, which is
+// all devices.json uses. Each object that carries a "pid" becomes one
+// entry; a top-level "vendor" supplies the default VID.
+// ------------------------------------------------------
+namespace {
+
+struct Scanner {
+    const std::string& s;
+    size_t i = 0;
+
+    void skipWs() { while (i < s.size() && std::isspace((unsigned char)s[i])) i++; }
+
+    bool readString(std::string& out) {
+        out.clear();
+        if (i >= s.size() || s[i] != '"') return false;
+        for (++i; i < s.size(); ++i) {
+            if (s[i] == '\\' && i + 1 < s.size()) { out += s[++i]; continue; }
+            if (s[i] == '"') { ++i; return true; }
+            out += s[i];
+        }
+        return false;
+    }
+
+    void readBare(std::string& out) {
+        out.clear();
+        while (i < s.size() && (std::isalnum((unsigned char)s[i]) || s[i] == '-' || s[i] == '.'))
+            out += s[i++];
+    }
+};
+
+bool parseNumber(const std::string& v, unsigned long& out) {
+    if (v.empty()) return false;
+    char* end = nullptr;
+    out = std::strtoul(v.c_str(), &end, 0);   // handles "0xC993" and 2024
+    return end && *end == '\0';
+}
+
+} // namespace
+
+bool LADeviceRegistry::parseDevicesFile(const std::string& content,
+                                        std::vector<LADeviceInfo>& out,
+                                        std::deque<std::string>& names)
+{
+    Scanner sc{content};
+    unsigned long vendor = 0x048D;
+
+    struct Obj {
+        unsigned long vid = 0, pid = 0, year = 0;
+        bool hasVid = false, hasPid = false;
+        std::string name;
+        float gamma = 1.0f;
+        std::array<float,3> wb{1.0f, 1.0f, 1.0f};
+    };
+    struct Arr { std::string key; size_t depth; size_t idx = 0; };   // open '[' and its owning object
+    std::vector<Obj> stack;
+    std::vector<Arr> arrays;
+    std::string key, val;
+    bool expectValue = false;
+
+    while (true) {
+        sc.skipWs();
+        if (sc.i >= content.size()) break;
+        char c = content[sc.i];
+
+        if (c == '{') { stack.emplace_back(); sc.i++; expectValue = false; continue; }
+        if (c == '}') {
+            if (stack.empty()) return false;
+            Obj o = stack.back();
+            stack.pop_back();
+            if (o.hasPid) {
+                names.push_back(o.name.empty() ? "Unknown" : o.name);
+                out.push_back(LADeviceInfo{
+                    (uint16_t)(o.hasVid ? o.vid : vendor), (uint16_t)o.pid,
+                    (uint16_t)o.year, names.back().c_str(), o.gamma, o.wb});
+            }
+            sc.i++;
+            expectValue = false;
+            continue;
+        }
+        if (c == '[') {
+            if (expectValue) arrays.push_back(Arr{key, stack.size()});
+            sc.i++; expectValue = false; continue;
+        }
+        if (c == ']') {
+            if (!arrays.empty()) arrays.pop_back();
+            sc.i++; expectValue = false; continue;
+        }
+        if (c == ',') {
+            if (!arrays.empty() && arrays.back().depth == stack.size()) arrays.back().idx++;
+            sc.i++; expectValue = false; continue;
+        }
+        if (c == ':') { sc.i++; expectValue = true; continue; }
+
+        if (c == '"') { if (!sc.readString(val)) return false; }
+        else {
+            sc.readBare(val);
+            if (val.empty()) return false;   // unexpected character
+        }
+
+        // Scalar array element, e.g. "whiteBalance": [1.0, 0.9, 0.8]
+        if (!expectValue && !arrays.empty() && arrays.back().depth == stack.size()) {
+            const Arr& a = arrays.back();
+            if (a.key == "whiteBalance" && !stack.empty() && a.idx < 3)
+                stack.back().wb[a.idx] = std::strtof(val.c_str(), nullptr);
+            continue;
+        }
+        if (!expectValue) { key = val; continue; }
+        expectValue = false;
+        if (stack.empty()) continue;
+
+        unsigned long n = 0;
+        Obj& o = stack.back();
+        if (key == "name") o.name = val;
+        else if (key == "pid" && parseNumber(val, n)) { o.pid = n; o.hasPid = true; }
+        else if (key == "vid" && parseNumber(val, n)) { o.vid = n; o.hasVid = true; }
+        else if (key == "year" && parseNumber(val, n)) o.year = n;
+        else if (key == "gamma") o.gamma = std::strtof(val.c_str(), nullptr);
+        else if (key == "vendor" && stack.size() == 1 && parseNumber(val, n)) vendor = n;
+    }
+    return stack.empty();
+}
+
+bool LADeviceRegistry::loadOverrides(const std::string& path) {
+    std::ifstream f(path);
+    if (!f.is_open()) return false;
+
+    std::stringstream buffer;
+    buffer << f.rdbuf();
+
+    std::vector<LADeviceInfo> list;
+    if (!parseDevicesFile(buffer.str(), list, names_)) return false;
+
+    for (auto& d : list) overrides_[laDeviceKey(d.vid, d.pid)] = d;
+    return true;
+}
+
+const LADeviceRegistry& LADeviceRegistry::instance() {
+    // Built in place: overrides_ points into names_, so it must never be copied
+    static LADeviceRegistry reg;
+    static const bool loaded = []{
+        if (const char* p = std::getenv("LEGIONAURA_DEVICES"); p && *p)
+            return reg.loadOverrides(p);
+
+        std::string cfg;
+        if (const char* x = std::getenv("XDG_CONFIG_HOME"); x && *x) cfg = x;
+        else if (const char* h = std::getenv("HOME"); h && *h) cfg = std::string(h) + "/.config";
+        if (!cfg.empty() && reg.loadOverrides(cfg + "/legionaura/devices.json"))
+            return true;
+        return reg.loadOverrides("/etc/legionaura/devices.json");
+    }();
+    (void)loaded;
+    return reg;
+}
+
+const LADeviceInfo* LADeviceRegistry::find(uint16_t vid, uint16_t pid) const {
+    if (!overrides_.empty()) {
+        auto it = overrides_.find(laDeviceKey(vid, pid));
+        if (it != overrides_.end()) return &it->second;
+    }
+    return laFindBuiltinDevice(vid, pid);
+}
+
+std::vector<LADeviceInfo> LADeviceRegistry::all() const {
+    std::vector<LADeviceInfo> list;
+    list.reserve(overrides_.size() + kLADeviceCount);
+    for (auto& kv : overrides_) list.push_back(kv.second);
+    for (auto& d : kLABuiltinDevices)
+        if (!overrides_.count(laDeviceKey(d.vid, d.pid))) list.push_back(d);
+    return list;
+}
@@ -0,0 +1,103 @@
+// LegionAura/lib/device_table.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LADeviceInfo {
+    uint16_t vid;
+    uint16_t pid;
+    uint16_t year;
+    const char* name;
+    float gamma;                        // color correction, see color.h (1 = raw)
+    std::array<float,3> whiteBalance;   // R/G/B gains (1 = unchanged)
+};
+
+// kLABuiltinDevices[], generated at build time from devices/devices.json
+#include "la_devices_generated.h"
+
+// ------------------------------------------------------
+// Compile-time perfect lookup over the builtin table: open addressing
+// with linear probing in a power-of-two index at most half full.
+// ------------------------------------------------------
+constexpr size_t kLADeviceCount = sizeof(kLABuiltinDevices) / sizeof(kLABuiltinDevices[0]);
+
+constexpr uint32_t laDeviceKey(uint16_t vid, uint16_t pid) {
+    return (uint32_t(vid) << 16) | pid;
+}
+
+constexpr size_t laDeviceIndexBits() {
+    size_t bits = 1;
+    while ((size_t(1) << bits) < kLADeviceCount * 2) bits++;
+    return bits;
+}
+
+constexpr size_t kLADeviceIndexSize = size_t(1) << laDeviceIndexBits();
+
+constexpr size_t laDeviceSlot(uint32_t key) {
+    return (size_t)((key * 0x9E3779B1u) >> (32 - laDeviceIndexBits()));
+}
+
+constexpr std::array<int16_t, kLADeviceIndexSize> laBuildDeviceIndex() {
+    std::array<int16_t, kLADeviceIndexSize> idx{};
+    for (size_t s = 0; s < kLADeviceIndexSize; ++s) idx[s] = -1;
+    for (size_t i = 0; i < kLADeviceCount; ++i) {
+        size_t s = laDeviceSlot(laDeviceKey(kLABuiltinDevices[i].vid, kLABuiltinDevices[i].pid));
+        while (idx[s] >= 0) s = (s + 1) & (kLADeviceIndexSize - 1);
+        idx[s] = (int16_t)i;
+    }
+    return idx;
+}
+
+inline constexpr auto kLADeviceIndex = laBuildDeviceIndex();
+
+constexpr const LADeviceInfo* laFindBuiltinDevice(uint16_t vid, uint16_t pid) {
+    const uint32_t key = laDeviceKey(vid, pid);
+    for (size_t s = laDeviceSlot(key); kLADeviceIndex[s] >= 0; s = (s + 1) & (kLADeviceIndexSize - 1)) {
+        const LADeviceInfo& d = kLABuiltinDevices[kLADeviceIndex[s]];
+        if (laDeviceKey(d.vid, d.pid) == key) return &d;
+    }
+    return nullptr;
+}
+
+constexpr bool laBuiltinTableConsistent() {
+    for (size_t i = 0; i < kLADeviceCount; ++i)
+        if (laFindBuiltinDevice(kLABuiltinDevices[i].vid, kLABuiltinDevices[i].pid) != &kLABuiltinDevices[i])
+            return false;   // duplicate VID/PID in devices.json
+    return true;
+}
+static_assert(kLADeviceCount > 0, "devices.json lists no models");
+static_assert(laBuiltinTableConsistent(), "devices.json contains duplicate VID/PID entries");
+
+// ------------------------------------------------------
+// Builtin table plus an optional runtime override file in the same
+// format as devices.json. Overrides win for the same VID/PID.
+//   $LEGIONAURA_DEVICES, else $XDG_CONFIG_HOME/legionaura/devices.json,
+//   else /etc/legionaura/devices.json
+// ------------------------------------------------------
+class LADeviceRegistry {
+public:
+    static const LADeviceRegistry& instance();   // loads the override file once
+
+    const LADeviceInfo* find(uint16_t vid, uint16_t pid) const;
+    std::vector<LADeviceInfo> all() const;       // overrides first, then builtin
+
+    // Small non-regex reader for devices.json-style files.
+    static bool parseDevicesFile(const std::string& content,
+                                 std::vector<LADeviceInfo>& out,
+                                 std::deque<std::string>& names);
+
+private:
+    bool loadOverrides(const std::string& path);
+
+    LADeviceRegistry() = default;
+    LADeviceRegistry(const LADeviceRegistry&) = delete;
+    LADeviceRegistry& operator=(const LADeviceRegistry&) = delete;
+
+    std::unordered_map<uint32_t, LADeviceInfo> overrides_;
+    std::deque<std::string> names_;   // backing storage for overrides_[].name
+};
@@ -0,0 +1,90 @@
+// /LegionAura/lib/frame_mailbox.cpp
+
+#include <thread>
+
+#include "frame_mailbox.h"
+
+LAFrameMailbox::LAFrameMailbox() {
+    for (uint32_t i = 0; i < kSlots; ++i)
+        slots_[i].next.store(i + 1 < kSlots ? i + 1 : kNil, std::memory_order_relaxed);
+    free_.store(0, std::memory_order_relaxed);   // tag 0, top = slot 0
+}
+
+uint32_t LAFrameMailbox::acquire() {
+    uint64_t head = free_.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t top = (uint32_t)head;
+        if (top == kNil) {
+            // Every buffer is held by another producer; they finish quickly
+            std::this_thread::yield();
+            head = free_.load(std::memory_order_acquire);
+            continue;
+        }
+        const uint64_t next = ((head >> 32) + 1) << 32 | slots_[top].next.load(std::memory_order_relaxed);
+        if (free_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire))
+            return top;
+    }
+}
+
+void LAFrameMailbox::release(uint32_t idx) {
+    uint64_t head = free_.load(std::memory_order_relaxed);
+    for (;;) {
+        slots_[idx].next.store((uint32_t)head, std::memory_order_relaxed);
+        const uint64_t next = ((head >> 32) + 1) << 32 | idx;
+        if (free_.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+}
+
+bool LAFrameMailbox::post(const LAPacket& p) {
+    const uint32_t idx = acquire();
+    slots_[idx].pkt = p;
+    posted_.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t old = pending_.exchange(idx, std::memory_order_seq_cst);
+    if (old != kNil) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+        release(old);
+    }
+
+    // Pairs with the sleeping_/pending_ re-check in wait()
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        cv_.notify_one();
+    }
+    return old != kNil;
+}
+
+bool LAFrameMailbox::take(LAPacket& out) {
+    const uint32_t idx = pending_.exchange(kNil, std::memory_order_acq_rel);
+    if (idx == kNil) return false;
+    out = slots_[idx].pkt;
+    release(idx);
+    return true;
+}
+
+bool LAFrameMailbox::wait(LAPacket& out) {
+    for (;;) {
+        if (take(out)) return true;
+        if (closed_.load()) return false;
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        cv_.wait(lk, [&]{
+            return pending_.load(std::memory_order_seq_cst) != kNil || closed_.load();
+        });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void LAFrameMailbox::close() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        closed_.store(true);
+    }
+    cv_.notify_all();
+}
+
+void LAFrameMailbox::reopen() {
+    closed_.store(false);
+}
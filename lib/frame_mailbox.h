@@ -0,0 +1,65 @@
+// LegionAura/lib/frame_mailbox.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "packet.h"
+
+// ------------------------------------------------------
+// Single-slot "latest wins" mailbox between frame producers and the
+// USB writer thread. post() never blocks and never queues: a frame the
+// writer has not picked up yet is replaced (and counted as coalesced),
+// so a producer faster than the controller costs dropped intermediate
+// frames instead of a growing backlog.
+//
+// Frames live in a small fixed pool. The pending frame is an atomic
+// pool index swapped in by producers and out by the writer; spare
+// buffers sit on a tagged (ABA-safe) lock-free stack. Only an idle
+// writer touches the mutex, to sleep.
+// ------------------------------------------------------
+class LAFrameMailbox {
+public:
+    // Buffers: one pending, one being copied out, the rest for producers
+    // mid-post. More concurrent producers than that briefly spin.
+    static constexpr uint32_t kSlots = 16;
+
+    LAFrameMailbox();
+
+    // Any thread. Returns true if it replaced an unsent frame.
+    bool post(const LAPacket& p);
+
+    // Writer side. take() returns the newest frame if there is one;
+    // wait() blocks for one and returns false once closed and drained.
+    bool take(LAPacket& out);
+    bool wait(LAPacket& out);
+
+    void close();    // wakes the writer; frames already posted are still handed out
+    void reopen();
+
+    uint64_t posted() const { return posted_.load(std::memory_order_relaxed); }
+    uint64_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+    uint32_t acquire();            // pop a spare buffer
+    void release(uint32_t idx);    // push it back
+
+    struct Slot {
+        LAPacket pkt{};
+        std::atomic<uint32_t> next{kNil};
+    };
+    std::array<Slot, kSlots> slots_;
+    std::atomic<uint64_t> free_;            // (tag << 32) | top index
+    std::atomic<uint32_t> pending_{kNil};
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> coalesced_{0};
+
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> sleeping_{false};
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
@@ -0,0 +1,165 @@
+// /LegionAura/lib/hidraw.cpp
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <linux/hidraw.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "hidraw.h"
+#include "color.h"
+#include "device_table.h"
+
+// DISCOVERY --------------------------------------------------------
+
+// "HID_ID=0003:0000048D:0000C993" from a hidraw device's uevent
+static bool readHidId(const std::string& ueventPath, uint16_t& vid, uint16_t& pid) {
+    std::ifstream f(ueventPath);
+    for (std::string line; std::getline(f, line);) {
+        if (line.compare(0, 7, "HID_ID=") != 0) continue;
+        unsigned bus, v, p;
+        if (std::sscanf(line.c_str() + 7, "%x:%x:%x", &bus, &v, &p) != 3) return false;
+        vid = (uint16_t)v;
+        pid = (uint16_t)p;
+        return true;
+    }
+    return false;
+}
+
+// Walks the short items of a HID report descriptor looking for a
+// Report ID (global item, tag 0x84) of 0xCC
+bool LAHidrawTransport::hasLightingReport(const uint8_t* desc, size_t len) {
+    for (size_t i = 0; i < len;) {
+        const uint8_t prefix = desc[i];
+        if (prefix == 0xFE) {                       // long item: size, tag, data
+            if (i + 1 >= len) return false;
+            i += 3 + desc[i + 1];
+            continue;
+        }
+        const size_t size = (prefix & 3) == 3 ? 4 : (prefix & 3);
+        if ((prefix & 0xFC) == 0x84 && size >= 1 && i + 1 < len && desc[i + 1] == 0xCC)
+            return true;
+        i += 1 + size;
+    }
+    return false;
+}
+
+std::vector<LAHidrawNode> LAHidrawTransport::find(const std::string& root) {
+    std::vector<LAHidrawNode> out;
+    const std::string cls = root + "/sys/class/hidraw";
+
+    DIR* d = opendir(cls.c_str());
+    if (!d) return out;
+
+    const auto& registry = LADeviceRegistry::instance();
+    while (dirent* e = readdir(d)) {
+        const std::string name = e->d_name;
+        if (name.compare(0, 6, "hidraw") != 0) continue;
+
+        LAHidrawNode n;
+        n.name = name;
+        n.devnode = root + "/dev/" + name;
+        if (!readHidId(cls + "/" + name + "/device/uevent", n.vid, n.pid)) continue;
+        if (!registry.find(n.vid, n.pid)) continue;
+
+        // No descriptor to check (old kernels): let the open decide
+        std::ifstream rd(cls + "/" + name + "/device/report_descriptor", std::ios::binary);
+        if (rd) {
+            std::vector<uint8_t> desc((std::istreambuf_iterator<char>(rd)), std::istreambuf_iterator<char>());
+            if (!desc.empty() && !hasLightingReport(desc.data(), desc.size())) continue;
+        }
+        out.push_back(n);
+    }
+    closedir(d);
+
+    std::sort(out.begin(), out.end(), [](const LAHidrawNode& a, const LAHidrawNode& b) {
+        return std::atoi(a.name.c_str() + 6) < std::atoi(b.name.c_str() + 6);
+    });
+    return out;
+}
+
+// Same model setup as a libusb open (color profile, shadow seed), but
+// the packets go through the first usable hidraw node
+bool LegionAura::openHidraw(const std::string& root) {
+    close();
+
+    int err = 0;
+    std::string denied;
+    for (const LAHidrawNode& n : LAHidrawTransport::find(root)) {
+        auto t = LAHidrawTransport::open(n.devnode, &err);
+        if (!t) {
+            if (err == EACCES || err == EPERM) denied = n.devnode;
+            continue;
+        }
+        vid_ = n.vid; pid_ = n.pid;
+        setColorProfile(LAColorProfile::forDevice(vid_, pid_));
+        return openWith(std::move(t));
+    }
+
+    if (!denied.empty())
+        std::cerr << "Permission denied on " << denied << ".\n"
+                     "Install the udev rules (udev/10-legionaura.rules, it covers hidraw too)\n"
+                     "or run with sudo.\n";
+    return false;
+}
+
+// TRANSPORT --------------------------------------------------------
+
+std::unique_ptr<LAHidrawTransport> LAHidrawTransport::open(const std::string& devnode, int* errnoOut) {
+    int fd = ::open(devnode.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        if (errnoOut) *errnoOut = errno;
+        return nullptr;
+    }
+    return std::unique_ptr<LAHidrawTransport>(new LAHidrawTransport(fd));
+}
+
+LAHidrawTransport::~LAHidrawTransport() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+int LAHidrawTransport::featureIoctl(bool set, uint8_t* buf, uint16_t len) {
+    int r = ::ioctl(fd_, set ? HIDIOCSFEATURE(len) : HIDIOCGFEATURE(len), buf);
+    return r < 0 ? -errno : r;
+}
+
+int LAHidrawTransport::setReport(const uint8_t* data, uint16_t len, unsigned) {
+    // The ioctl takes a mutable buffer; reports are at most 64 bytes
+    std::array<uint8_t,64> buf;
+    if (len == 0 || len > buf.size()) return LIBUSB_ERROR_INVALID_PARAM;
+    std::memcpy(buf.data(), data, len);
+
+    int r = featureIoctl(true, buf.data(), len);
+    return r < 0 ? libusbError(-r) : r;
+}
+
+int LAHidrawTransport::getReport(uint8_t* data, uint16_t len, unsigned) {
+    if (len == 0) return LIBUSB_ERROR_INVALID_PARAM;
+    data[0] = 0xCC;   // report id to fetch; the reply starts with it too
+
+    int r = featureIoctl(false, data, len);
+    return r < 0 ? libusbError(-r) : r;
+}
+
+int LAHidrawTransport::libusbError(int err) {
+    switch (err) {
+        case ENODEV: case ENXIO:  return LIBUSB_ERROR_NO_DEVICE;
+        case EACCES: case EPERM:  return LIBUSB_ERROR_ACCESS;
+        case ETIMEDOUT:           return LIBUSB_ERROR_TIMEOUT;
+        case EPIPE:               return LIBUSB_ERROR_PIPE;
+        case EBUSY:               return LIBUSB_ERROR_BUSY;
+        case EINVAL:              return LIBUSB_ERROR_INVALID_PARAM;
+        case EINTR:               return LIBUSB_ERROR_INTERRUPTED;
+        case ENOMEM:              return LIBUSB_ERROR_NO_MEM;
+        default:                  return LIBUSB_ERROR_IO;
+    }
+}
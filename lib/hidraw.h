@@ -0,0 +1,58 @@
+// LegionAura/lib/hidraw.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+
+// One /dev/hidrawN belonging to a supported controller
+struct LAHidrawNode {
+    std::string name;      // "hidraw3"
+    std::string devnode;   // <root>/dev/hidraw3
+    uint16_t vid = 0, pid = 0;
+};
+
+// ------------------------------------------------------
+// Feature reports through the kernel's hidraw driver instead of libusb:
+// HIDIOCSFEATURE/HIDIOCGFEATURE on /dev/hidrawN carry the same 0x03CC
+// report as the control transfers (the buffer starts with report id
+// 0xCC), so there is no libusb context to start, no kernel driver to
+// detach and no interface to claim, and each packet is one ioctl.
+//
+// Nodes are found through sysfs: <root>/sys/class/hidraw/*/device/uevent
+// gives HID_ID=bus:vendor:product, and the report descriptor next to it
+// must declare report id 0xCC (the controller exposes several HID
+// interfaces; only one takes lighting reports). `root` is empty on a
+// real system and points at a fake tree in tests.
+//
+// The kernel applies its own control-transfer timeout (5 s), so
+// timeoutMs is not used.
+// ------------------------------------------------------
+class LAHidrawTransport : public LATransport {
+public:
+    static std::vector<LAHidrawNode> find(const std::string& root = "");   // sorted by node number
+    static bool hasLightingReport(const uint8_t* desc, size_t len);         // report id 0xCC declared
+
+    // nullptr if the node can't be opened; errnoOut gets the reason
+    static std::unique_ptr<LAHidrawTransport> open(const std::string& devnode, int* errnoOut = nullptr);
+
+    ~LAHidrawTransport() override;
+    LAHidrawTransport(const LAHidrawTransport&) = delete;
+    LAHidrawTransport& operator=(const LAHidrawTransport&) = delete;
+
+    int setReport(const uint8_t* data, uint16_t len, unsigned timeoutMs) override;
+    int getReport(uint8_t* data, uint16_t len, unsigned timeoutMs) override;
+
+    static int libusbError(int err);   // errno -> the LIBUSB_ERROR_* LATransport reports
+
+protected:
+    explicit LAHidrawTransport(int fd) : fd_(fd) {}
+
+    // The two ioctls. Returns the byte count or -errno; overridden to
+    // stand in for a device in tests.
+    virtual int featureIoctl(bool set, uint8_t* buf, uint16_t len);
+
+    int fd_ = -1;
+};
@@ -0,0 +1,141 @@
+// /LegionAura/lib/hotplug.cpp
+
+#include <iostream>
+#include <sys/time.h>
+
+#include "legionaura.h"
+#include "async_transfer.h"
+
+// ------------------------------------------------------
+// Hotplug handling. libusb only delivers hotplug callbacks while some
+// thread is handling events, so enableHotplug() starts one that sleeps
+// in libusb_handle_events_timeout_completed(). The callback itself only
+// records what happened; reopening and replaying happens on that thread
+// once event handling returns, where blocking libusb calls are allowed.
+// ------------------------------------------------------
+
+bool LegionAura::enableHotplug(std::function<void(bool connected)> onChange) {
+    if (hpRunning_.load()) return true;
+    if (!ctx_ || !dev_) return false;
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) return false;
+
+    onConnChange_ = std::move(onChange);
+    {
+        std::lock_guard<std::mutex> lk(hpMtx_);
+        usbDev_ = libusb_get_device(dev_);
+    }
+
+    int rc = libusb_hotplug_register_callback(
+        ctx_,
+        LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+        LIBUSB_HOTPLUG_NO_FLAGS,
+        vid_, pid_, LIBUSB_HOTPLUG_MATCH_ANY,
+        &LegionAura::onHotplug, this, &hpHandle_);
+    if (rc != 0) return false;
+
+    hpRunning_.store(true);
+    hpThread_ = std::thread(&LegionAura::hotplugLoop, this);
+    return true;
+}
+
+void LegionAura::disableHotplug() {
+    if (!hpRunning_.exchange(false)) return;
+
+    libusb_hotplug_deregister_callback(ctx_, hpHandle_);
+    libusb_interrupt_event_handler(ctx_);
+    hpThread_.join();
+
+    std::lock_guard<std::mutex> lk(hpMtx_);
+    if (pendingArrival_) libusb_unref_device(pendingArrival_);
+    pendingArrival_ = nullptr;
+    pendingLeft_ = false;
+}
+
+int LIBUSB_CALL LegionAura::onHotplug(libusb_context*, libusb_device* dev,
+                                      libusb_hotplug_event event, void* self)
+{
+    auto* kb = static_cast<LegionAura*>(self);
+    std::lock_guard<std::mutex> lk(kb->hpMtx_);
+
+    if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT) {
+        if (dev == kb->usbDev_) kb->pendingLeft_ = true;
+    } else if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+        if (kb->pendingArrival_) libusb_unref_device(kb->pendingArrival_);
+        kb->pendingArrival_ = libusb_ref_device(dev);
+    }
+    return 0; // stay registered
+}
+
+void LegionAura::hotplugLoop() {
+    while (hpRunning_.load()) {
+        timeval tv{1, 0};
+        libusb_handle_events_timeout_completed(ctx_, &tv, nullptr);
+
+        bool left;
+        libusb_device* arrived;
+        {
+            std::lock_guard<std::mutex> lk(hpMtx_);
+            left = pendingLeft_;
+            arrived = pendingArrival_;
+            pendingLeft_ = false;
+            pendingArrival_ = nullptr;
+        }
+
+        if (left) handleDeviceLeft();
+        if (arrived) {
+            handleDeviceArrived(arrived);
+            libusb_unref_device(arrived);
+        }
+    }
+}
+
+void LegionAura::handleDeviceLeft() {
+    std::unique_ptr<LAAsyncEngine> engine;
+    {
+        std::lock_guard<std::mutex> io(ioMtx_);
+        if (!dev_) return;
+        engine = std::move(async_);
+        libusb_close(dev_);   // interface is gone with the device; nothing to release
+        dev_ = nullptr;
+    }
+    // Outside ioMtx_: completions may call back into apply()
+    engine.reset();
+
+    {
+        std::lock_guard<std::mutex> lk(hpMtx_);
+        usbDev_ = nullptr;
+    }
+    invalidateShadow();
+
+    if (onConnChange_) onConnChange_(false);
+}
+
+void LegionAura::handleDeviceArrived(libusb_device* dev) {
+    {
+        std::lock_guard<std::mutex> io(ioMtx_);
+        if (dev_) return;   // still attached to a device: not ours to take
+
+        libusb_device_handle* h = nullptr;
+        if (libusb_open(dev, &h) != 0) return;
+        if (!claim(h)) {
+            libusb_close(h);
+            return;
+        }
+        dev_ = h;
+    }
+    {
+        std::lock_guard<std::mutex> lk(hpMtx_);
+        usbDev_ = dev;
+    }
+
+    // Firmware comes back in its power-on default; put our state back
+    std::optional<std::array<uint8_t,32>> last;
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        last = lastPayload_;
+    }
+    if (last && !send(*last))
+        std::cerr << "legionaura: reconnected but failed to restore lighting\n";
+
+    if (onConnChange_) onConnChange_(true);
+}
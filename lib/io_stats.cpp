@@ -0,0 +1,199 @@
+// /LegionAura/lib/io_stats.cpp
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "io_stats.h"
+
+// HISTOGRAM --------------------------------------------------------
+
+int LALatencyHistogram::bucketFor(uint64_t us) {
+    int b = 0;
+    while (us && b < LA_LAT_BUCKETS - 1) { us >>= 1; b++; }
+    return b;
+}
+
+uint64_t LALatencyHistogram::bucketUpperUs(int bucket) {
+    return uint64_t(1) << bucket;
+}
+
+double LALatencyHistogram::percentileUs(double q) const {
+    if (!count) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)(q * count + 0.5));
+    uint64_t seen = 0;
+    for (int b = 0; b < LA_LAT_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) return (double)std::min(bucketUpperUs(b), maxUs);
+    }
+    return (double)maxUs;
+}
+
+void LALatencyHistogram::add(uint64_t us) {
+    buckets[bucketFor(us)]++;
+    count++;
+    sumUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+void LALatencyHistogram::merge(const LALatencyHistogram& o) {
+    for (int b = 0; b < LA_LAT_BUCKETS; ++b) buckets[b] += o.buckets[b];
+    count += o.count;
+    sumUs += o.sumUs;
+    maxUs = std::max(maxUs, o.maxUs);
+}
+
+LALatencyHistogram LAIoOpStats::all() const {
+    LALatencyHistogram h;
+    for (auto& r : byResult) h.merge(r);
+    return h;
+}
+
+uint64_t LAIoOpStats::count(int code) const {
+    return byResult[laIoResultSlot(code)].count;
+}
+
+uint64_t LAIoOpStats::errors() const {
+    uint64_t n = 0;
+    for (int s = 1; s < LA_IO_RESULTS; ++s) n += byResult[s].count;
+    return n;
+}
+
+// RESULT CODES -----------------------------------------------------
+
+int laIoResultSlot(int code) {
+    if (code == 0) return 0;
+    if (code == LA_IO_SHORT) return 1;
+    if (code <= -1 && code >= -12) return 1 - code;   // -1 -> 2 .. -12 -> 13
+    return LA_IO_RESULTS - 1;
+}
+
+int laIoResultCode(int slot) {
+    if (slot == 0) return 0;
+    if (slot == 1) return LA_IO_SHORT;
+    if (slot < LA_IO_RESULTS - 1) return 1 - slot;
+    return -99;   // LIBUSB_ERROR_OTHER
+}
+
+const char* laIoResultName(int code) {
+    switch (code) {
+        case 0:           return "ok";
+        case LA_IO_SHORT: return "short";
+        case -1:  return "io";
+        case -2:  return "invalid_param";
+        case -3:  return "access";
+        case -4:  return "no_device";
+        case -5:  return "not_found";
+        case -6:  return "busy";
+        case -7:  return "timeout";
+        case -8:  return "overflow";
+        case -9:  return "pipe";
+        case -10: return "interrupted";
+        case -11: return "no_mem";
+        case -12: return "not_supported";
+        default:  return "other";
+    }
+}
+
+const char* laIoOpName(LAIoOp op) {
+    return op == LAIoOp::SetReport ? "set_report" : "get_report";
+}
+
+// RECORDER ---------------------------------------------------------
+
+void LAIoRecorder::record(LAIoOp op, int code, uint64_t us) {
+    Hist& h = hist_[(int)op][laIoResultSlot(code)];
+    h.buckets[LALatencyHistogram::bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.sumUs.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t prev = h.maxUs.load(std::memory_order_relaxed);
+    while (us > prev && !h.maxUs.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+}
+
+LAIoStats LAIoRecorder::snapshot() const {
+    LAIoStats s;
+    for (int o = 0; o < LA_IO_OPS; ++o) {
+        for (int r = 0; r < LA_IO_RESULTS; ++r) {
+            const Hist& h = hist_[o][r];
+            LALatencyHistogram& out = s.ops[o].byResult[r];
+            for (int b = 0; b < LA_LAT_BUCKETS; ++b)
+                out.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+            out.count = h.count.load(std::memory_order_relaxed);
+            out.sumUs = h.sumUs.load(std::memory_order_relaxed);
+            out.maxUs = h.maxUs.load(std::memory_order_relaxed);
+        }
+    }
+    return s;
+}
+
+void LAIoRecorder::reset() {
+    for (auto& op : hist_) {
+        for (auto& h : op) {
+            for (auto& b : h.buckets) b.store(0, std::memory_order_relaxed);
+            h.count.store(0, std::memory_order_relaxed);
+            h.sumUs.store(0, std::memory_order_relaxed);
+            h.maxUs.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// PROMETHEUS -------------------------------------------------------
+
+std::string laIoStatsPrometheus(const LAIoStats& s, const std::string& labels) {
+    std::ostringstream out;
+    const std::string sep = labels.empty() ? "" : ",";
+
+    out << "# HELP legionaura_transfers_total Control transfers by request and result.\n"
+        << "# TYPE legionaura_transfers_total counter\n";
+    for (int o = 0; o < LA_IO_OPS; ++o) {
+        for (int r = 0; r < LA_IO_RESULTS; ++r) {
+            uint64_t n = s.ops[o].byResult[r].count;
+            if (!n && r != 0) continue;   // always export ok so the series exists
+            out << "legionaura_transfers_total{" << labels << sep
+                << "op=\"" << laIoOpName((LAIoOp)o) << "\",result=\""
+                << laIoResultName(laIoResultCode(r)) << "\"} " << n << "\n";
+        }
+    }
+
+    out << "# HELP legionaura_transfer_duration_seconds Control transfer latency.\n"
+        << "# TYPE legionaura_transfer_duration_seconds histogram\n";
+    for (int o = 0; o < LA_IO_OPS; ++o) {
+        const LALatencyHistogram h = s.ops[o].all();
+        const std::string base = std::string("{") + labels + sep + "op=\"" + laIoOpName((LAIoOp)o) + "\"";
+
+        uint64_t cum = 0;
+        for (int b = 0; b < LA_LAT_BUCKETS - 1; ++b) {
+            cum += h.buckets[b];
+            char le[32];
+            std::snprintf(le, sizeof(le), "%g", LALatencyHistogram::bucketUpperUs(b) / 1e6);
+            out << "legionaura_transfer_duration_seconds_bucket" << base
+                << ",le=\"" << le << "\"} " << cum << "\n";
+        }
+        out << "legionaura_transfer_duration_seconds_bucket" << base << ",le=\"+Inf\"} " << h.count << "\n"
+            << "legionaura_transfer_duration_seconds_sum" << base << "} " << h.sumUs / 1e6 << "\n"
+            << "legionaura_transfer_duration_seconds_count" << base << "} " << h.count << "\n";
+    }
+
+    out << "# HELP legionaura_transfer_max_seconds Slowest control transfer seen.\n"
+        << "# TYPE legionaura_transfer_max_seconds gauge\n";
+    for (int o = 0; o < LA_IO_OPS; ++o)
+        out << "legionaura_transfer_max_seconds{" << labels << sep << "op=\""
+            << laIoOpName((LAIoOp)o) << "\"} " << s.ops[o].all().maxUs / 1e6 << "\n";
+
+    return out.str();
+}
+
+bool laWriteIoStatsPrometheus(const std::string& path, const LAIoStats& s,
+                              const std::string& labels)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::trunc);
+        if (!f) return false;
+        f << laIoStatsPrometheus(s, labels);
+        if (!f.flush()) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
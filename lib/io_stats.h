@@ -0,0 +1,90 @@
+// LegionAura/lib/io_stats.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// ------------------------------------------------------
+// Control-transfer health: every SET_REPORT/GET_REPORT is recorded with
+// its outcome (success, short transfer, or the libusb error code) and
+// its latency in a log2-bucketed histogram. Recording is a handful of
+// relaxed atomic adds, so it stays on in production.
+// ------------------------------------------------------
+
+enum class LAIoOp : uint8_t { SetReport = 0, GetReport = 1 };
+constexpr int LA_IO_OPS = 2;
+
+// Result codes are libusb's (0 = ok, LIBUSB_ERROR_* < 0) plus this one
+// for a transfer that completed with fewer bytes than requested.
+constexpr int LA_IO_SHORT = 1;
+
+// ok, short, LIBUSB_ERROR_IO (-1) .. LIBUSB_ERROR_NOT_SUPPORTED (-12), other
+constexpr int LA_IO_RESULTS = 15;
+
+// Bucket 0 holds < 1 us; bucket k holds [2^(k-1), 2^k) us; the last one
+// everything from 2^(N-2) us (~4 s) up.
+constexpr int LA_LAT_BUCKETS = 24;
+
+struct LALatencyHistogram {
+    std::array<uint64_t, LA_LAT_BUCKETS> buckets{};
+    uint64_t count = 0;
+    uint64_t sumUs = 0;
+    uint64_t maxUs = 0;
+
+    static int bucketFor(uint64_t us);
+    static uint64_t bucketUpperUs(int bucket);   // exclusive bound
+
+    // Upper bound of the bucket holding the q-quantile (0..1), capped at
+    // the observed maximum. 0 when empty.
+    double percentileUs(double q) const;
+    double meanUs() const { return count ? (double)sumUs / count : 0; }
+    void add(uint64_t us);   // single-threaded; LAIoRecorder is the concurrent one
+    void merge(const LALatencyHistogram& o);
+};
+
+struct LAIoOpStats {
+    std::array<LALatencyHistogram, LA_IO_RESULTS> byResult;   // index: laIoResultSlot()
+
+    LALatencyHistogram all() const;                           // every outcome merged
+    uint64_t count(int code) const;                           // 0 = successes
+    uint64_t errors() const;                                  // everything but ok
+};
+
+// Plain data, so it can cross the daemon socket as-is
+struct LAIoStats {
+    std::array<LAIoOpStats, LA_IO_OPS> ops;
+    const LAIoOpStats& op(LAIoOp o) const { return ops[(int)o]; }
+};
+
+int laIoResultSlot(int code);
+int laIoResultCode(int slot);
+const char* laIoResultName(int code);   // "ok", "short", "timeout", ...
+const char* laIoOpName(LAIoOp op);      // "set_report", "get_report"
+
+// Prometheus text exposition format (for node_exporter's textfile
+// collector). `labels` is inserted into every sample, e.g.
+// `device="048d:c993"`; may be empty.
+std::string laIoStatsPrometheus(const LAIoStats& s, const std::string& labels = "");
+// Writes via a temporary file and rename(), so scrapes never see half a file
+bool laWriteIoStatsPrometheus(const std::string& path, const LAIoStats& s,
+                              const std::string& labels = "");
+
+// ------------------------------------------------------
+// Lock-free recorder; any thread may record() while another snapshots.
+// ------------------------------------------------------
+class LAIoRecorder {
+public:
+    void record(LAIoOp op, int code, uint64_t us);
+    LAIoStats snapshot() const;
+    void reset();
+
+private:
+    struct Hist {
+        std::array<std::atomic<uint64_t>, LA_LAT_BUCKETS> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumUs{0};
+        std::atomic<uint64_t> maxUs{0};
+    };
+    std::array<std::array<Hist, LA_IO_RESULTS>, LA_IO_OPS> hist_;
+};
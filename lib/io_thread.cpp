@@ -0,0 +1,136 @@
+// /LegionAura/lib/io_thread.cpp
+
+#include "io_thread.h"
+
+// QUEUE ------------------------------------------------------------
+
+void LACommandQueue::push(LACommandNode* n) {
+    n->next.store(nullptr, std::memory_order_relaxed);
+    LACommandNode* prev = tail_.exchange(n, std::memory_order_seq_cst);
+    prev->next.store(n, std::memory_order_release);
+}
+
+LACommandNode* LACommandQueue::pop() {
+    LACommandNode* h = head_;
+    LACommandNode* next = h->next.load(std::memory_order_acquire);
+
+    if (h == &stub_) {
+        if (!next) return nullptr;
+        head_ = h = next;
+        next = h->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        head_ = next;
+        return h;
+    }
+
+    // h is the last node we can see. If a producer already swapped the
+    // tail but has not linked it yet, come back later.
+    if (h != tail_.load(std::memory_order_acquire)) return nullptr;
+
+    // Re-insert the stub so h can be unlinked
+    push(&stub_);
+    next = h->next.load(std::memory_order_acquire);
+    if (next) {
+        head_ = next;
+        return h;
+    }
+    return nullptr;
+}
+
+// I/O THREAD -------------------------------------------------------
+
+LAIoThread::LAIoThread(LegionAura& kb) : kb_(kb) {
+    thread_ = std::thread(&LAIoThread::loop, this);
+}
+
+LAIoThread::~LAIoThread() {
+    stop();
+}
+
+void LAIoThread::enqueue(LACommandNode* n) {
+    // stop() waits for enqueuers that got past this check, so nothing is
+    // left behind in the queue once it returns
+    enqueuing_.fetch_add(1, std::memory_order_seq_cst);
+    if (stopping_.load(std::memory_order_seq_cst)) {
+        enqueuing_.fetch_sub(1);
+        delete n;   // breaks the promise
+        return;
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    queue_.push(n);
+    enqueuing_.fetch_sub(1);
+
+    // Pairs with sleeping_ + the idle() re-check in loop()
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        cv_.notify_one();
+    }
+}
+
+void LAIoThread::loop() {
+    for (;;) {
+        if (LACommandNode* n = queue_.pop()) {
+            n->run(kb_);
+            delete n;
+            completed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!queue_.idle()) {           // a push is mid-flight
+            std::this_thread::yield();
+            continue;
+        }
+        if (stopping_.load()) return;
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        cv_.wait(lk, [&]{ return !queue_.idle() || stopping_.load(); });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void LAIoThread::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        stopping_.store(true, std::memory_order_seq_cst);
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    // Raced with stop(): pushed after the thread's last look. Those still
+    // run, so every accepted command completes.
+    while (enqueuing_.load(std::memory_order_seq_cst)) std::this_thread::yield();
+    for (;;) {
+        LACommandNode* n = queue_.pop();
+        if (!n) {
+            if (queue_.idle()) break;
+            continue;
+        }
+        n->run(kb_);
+        delete n;
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// COMMANDS ---------------------------------------------------------
+
+std::future<bool> LAIoThread::apply(const LAParams& p) {
+    return submit([p](LegionAura& kb){ return kb.apply(p); });
+}
+
+std::future<bool> LAIoThread::off() {
+    return submit([](LegionAura& kb){ return kb.off(); });
+}
+
+std::future<bool> LAIoThread::setBrightnessOnly(uint8_t level) {
+    return submit([level](LegionAura& kb){ return kb.setBrightnessOnly(level); });
+}
+
+std::future<std::optional<LAParams>> LAIoThread::readState() {
+    return submit([](LegionAura& kb) -> std::optional<LAParams> {
+        LAParams st;
+        if (!kb.readState(st)) return std::nullopt;
+        return st;
+    });
+}
@@ -0,0 +1,107 @@
+// LegionAura/lib/io_thread.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include "legionaura.h"
+
+// ------------------------------------------------------
+// Intrusive multi-producer/single-consumer queue (D. Vyukov's design).
+// push() is one atomic exchange plus a store and never blocks; pop() is
+// consumer-only. A producer's commands come out in the order it pushed
+// them; commands from different producers interleave in push order.
+// ------------------------------------------------------
+struct LACommandNode {
+    std::atomic<LACommandNode*> next{nullptr};
+    virtual ~LACommandNode() = default;
+    virtual void run(LegionAura& kb) = 0;
+};
+
+class LACommandQueue {
+public:
+    LACommandQueue() : head_(&stub_), tail_(&stub_) {}
+
+    void push(LACommandNode* n);
+    // nullptr when empty, or while a producer is halfway through push()
+    // (the consumer just tries again).
+    LACommandNode* pop();
+    bool idle() const { return tail_.load() == head_; }   // consumer only
+
+private:
+    struct Stub : LACommandNode { void run(LegionAura&) override {} };
+
+    Stub stub_;
+    LACommandNode* head_;                  // consumer side
+    std::atomic<LACommandNode*> tail_;     // producer side
+};
+
+// ------------------------------------------------------
+// Thread-safe front end for one LegionAura. A single I/O thread owns
+// the instance and runs every command in queue order; any number of
+// threads (GUI, timers, effects) submit and get a future back. Nothing
+// else may call into `kb` while this runs.
+//
+// stop() (and the destructor) finishes every command already queued;
+// futures of commands submitted after that report broken_promise.
+// ------------------------------------------------------
+class LAIoThread {
+public:
+    explicit LAIoThread(LegionAura& kb);
+    ~LAIoThread();
+
+    LAIoThread(const LAIoThread&) = delete;
+    LAIoThread& operator=(const LAIoThread&) = delete;
+
+    std::future<bool> apply(const LAParams& p);
+    std::future<bool> off();
+    std::future<bool> setBrightnessOnly(uint8_t level);
+    std::future<std::optional<LAParams>> readState();
+
+    // Anything else (transition, autoDetect, ...): fn(LegionAura&) runs
+    // on the I/O thread.
+    template <class F>
+    auto submit(F fn) -> std::future<std::invoke_result_t<F, LegionAura&>>;
+
+    void stop();
+    uint64_t submitted() const { return submitted_.load(std::memory_order_relaxed); }
+    uint64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+
+private:
+    template <class R, class F>
+    struct Task : LACommandNode {
+        explicit Task(F f) : fn(std::move(f)) {}
+        void run(LegionAura& kb) override {
+            if constexpr (std::is_void_v<R>) { fn(kb); done.set_value(); }
+            else done.set_value(fn(kb));
+        }
+        F fn;
+        std::promise<R> done;
+    };
+
+    void enqueue(LACommandNode* n);
+    void loop();
+
+    LegionAura& kb_;
+    LACommandQueue queue_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> sleeping_{false};
+    std::atomic<uint64_t> submitted_{0}, completed_{0};
+    std::atomic<int> enqueuing_{0};
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+template <class F>
+auto LAIoThread::submit(F fn) -> std::future<std::invoke_result_t<F, LegionAura&>> {
+    using R = std::invoke_result_t<F, LegionAura&>;
+    auto* t = new Task<R, F>(std::move(fn));
+    auto fut = t->done.get_future();
+    enqueue(t);
+    return fut;
+}
@@ -0,0 +1,372 @@
+// /LegionAura/lib/ipc.cpp
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <chrono>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ipc.h"
+#include "packet.h"
+
+std::string laSocketPath() {
+    if (const char* s = std::getenv("LEGIONAURA_SOCKET"); s && *s)
+        return s;
+    if (::geteuid() == 0)
+        return LA_SYSTEM_SOCKET;
+    if (const char* r = std::getenv("XDG_RUNTIME_DIR"); r && *r)
+        return std::string(r) + "/legionaura.sock";
+    return "";
+}
+
+std::vector<std::string> laSocketCandidates() {
+    if (const char* s = std::getenv("LEGIONAURA_SOCKET"); s && *s)
+        return {s};
+    std::vector<std::string> out;
+    if (const char* r = std::getenv("XDG_RUNTIME_DIR"); r && *r)
+        out.push_back(std::string(r) + "/legionaura.sock");
+    out.push_back(LA_SYSTEM_SOCKET);
+    return out;
+}
+
+static bool validParams(const LAParams& p) {
+    return laIsValidEffect(p.effect) &&
+           p.speed >= 1 && p.speed <= 4 &&
+           p.brightness >= 1 && p.brightness <= 2 &&
+           (p.waveDir == LAWaveDir::None || p.waveDir == LAWaveDir::LTR || p.waveDir == LAWaveDir::RTL);
+}
+
+bool laIpcRequestValid(const LAIpcRequest& req) {
+    if (req.magic != LA_IPC_MAGIC) return false;
+    switch (req.op) {
+        case LAIpcOp::Ping:
+        case LAIpcOp::Off:        return true;
+        case LAIpcOp::ReadState:
+        case LAIpcOp::Stats:      return req.level <= 1;
+        case LAIpcOp::Brightness: return req.level >= 1 && req.level <= 2;
+        case LAIpcOp::Apply:      return req.percent <= 100 && validParams(req.params);
+        case LAIpcOp::Transition: return req.percent <= 100 && req.fadeMs <= LA_IPC_MAX_FADE_MS &&
+                                         validParams(req.params);
+    }
+    return false;
+}
+
+bool laSendAll(int fd, const void* buf, size_t len) {
+    auto p = static_cast<const uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n; len -= (size_t)n;
+    }
+    return true;
+}
+
+bool laRecvAll(int fd, void* buf, size_t len) {
+    auto p = static_cast<uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = ::recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n; len -= (size_t)n;
+    }
+    return true;
+}
+
+// CLIENT -----------------------------------------------------------
+
+LAClient::~LAClient(){ close(); }
+
+bool LAClient::connect() {
+    for (const std::string& path : laSocketCandidates())
+        if (connect(path)) return true;
+    return false;
+}
+
+bool LAClient::connect(const std::string& path) {
+    if (fd_ >= 0) return true;
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // Make sure the peer actually speaks our protocol before using it
+    fd_ = fd;
+    LAIpcRequest ping;
+    LAIpcReply rep;
+    if (!transact(ping, rep) || !rep.ok) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LAClient::close() {
+    if (fd_ < 0) return;
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool LAClient::transact(const LAIpcRequest& req, LAIpcReply& rep) {
+    if (fd_ < 0) return false;
+    if (!laSendAll(fd_, &req, sizeof(req)) || !laRecvAll(fd_, &rep, sizeof(rep))) {
+        close();
+        return false;
+    }
+    return rep.magic == LA_IPC_MAGIC;
+}
+
+bool LAClient::apply(const LAParams& p, uint8_t percent) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::Apply;
+    req.params = p;
+    req.percent = percent;
+    LAIpcReply rep;
+    return transact(req, rep) && rep.ok;
+}
+
+bool LAClient::transition(const LAParams& p, uint32_t fadeMs, uint8_t percent) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::Transition;
+    req.params = p;
+    req.percent = percent;
+    req.fadeMs = fadeMs;
+    LAIpcReply rep;
+    return transact(req, rep) && rep.ok;
+}
+
+bool LAClient::off() {
+    LAIpcRequest req;
+    req.op = LAIpcOp::Off;
+    LAIpcReply rep;
+    return transact(req, rep) && rep.ok;
+}
+
+bool LAClient::setBrightnessOnly(uint8_t level) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::Brightness;
+    req.level = level;
+    LAIpcReply rep;
+    return transact(req, rep) && rep.ok;
+}
+
+bool LAClient::readState(LAParams& out) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::ReadState;
+    LAIpcReply rep;
+    if (!transact(req, rep) || !rep.ok) return false;
+    out = rep.state;
+    return true;
+}
+
+bool LAClient::requestedState(LAParams& out) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::ReadState;
+    req.level = 1;
+    LAIpcReply rep;
+    if (!transact(req, rep) || !rep.ok) return false;
+    out = rep.state;
+    return true;
+}
+
+bool LAClient::stats(LAIpcStats& out, bool reset) {
+    LAIpcRequest req;
+    req.op = LAIpcOp::Stats;
+    req.level = reset ? 1 : 0;
+    LAIpcReply rep;
+    if (!transact(req, rep) || !rep.ok) return false;
+    if (!laRecvAll(fd_, &out, sizeof(out))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// SERVER -----------------------------------------------------------
+
+LAIpcServer::~LAIpcServer(){ close(); }
+
+bool LAIpcServer::listen(const std::string& path, std::string& err) {
+    close();
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        err = "Socket path too long: " + path;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    LAClient probe;
+    if (probe.connect(path)) {
+        err = "Another legionaurad is already listening on " + path;
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (path == LA_SYSTEM_SOCKET)
+        ::mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);   // fails harmlessly if it exists
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) { err = std::string("socket: ") + std::strerror(errno); return false; }
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 8) != 0) {
+        err = "bind " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    // Lighting is not sensitive; let unprivileged clients reach a root daemon
+    ::chmod(path.c_str(), 0666);
+
+    path_ = path;
+    fds_.assign(1, pollfd{fd, POLLIN, 0});
+    conns_.resize(1);
+    return true;
+}
+
+void LAIpcServer::close() {
+    fade_.reset();
+    fadeFd_ = -1;
+    for (auto& p : fds_) ::close(p.fd);
+    fds_.clear();
+    conns_.clear();
+    if (!path_.empty()) ::unlink(path_.c_str());
+    path_.clear();
+}
+
+LAIpcServer::ReadResult LAIpcServer::readRequest(int fd, Conn& c) {
+    auto p = reinterpret_cast<uint8_t*>(&c.req);
+    while (c.got < sizeof(c.req)) {
+        ssize_t n = ::recv(fd, p + c.got, sizeof(c.req) - c.got, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return ReadResult::Partial;
+        if (n <= 0) return ReadResult::Closed;
+        c.got += (size_t)n;
+    }
+    c.got = 0;
+    return ReadResult::Complete;
+}
+
+// Replies are small enough for the socket buffer; a client that never
+// reads them gets EAGAIN here and is dropped.
+bool LAIpcServer::reply(size_t k) {
+    const int fd = fds_[k].fd;
+    const LAIpcRequest& req = conns_[k].req;
+    if (!laIpcRequestValid(req)) return false;
+
+    const bool changesLighting = req.op == LAIpcOp::Apply || req.op == LAIpcOp::Transition ||
+                                 req.op == LAIpcOp::Off || req.op == LAIpcOp::Brightness;
+    if (fade_ && changesLighting) endFade();
+
+    LAIpcReply rep;
+    switch (req.op) {
+        case LAIpcOp::Ping:       rep.ok = 1; break;
+        case LAIpcOp::Apply:
+            kb_.setSoftwareBrightness(req.percent);
+            rep.ok = kb_.apply(req.params);
+            break;
+        case LAIpcOp::Transition:
+            // Replied to by endFade(); no more requests from this client until then
+            kb_.setSoftwareBrightness(req.percent);
+            fade_ = std::make_unique<LATransition>(kb_, req.params, std::chrono::milliseconds(req.fadeMs));
+            fadeFd_ = fd;
+            fds_[k].events = 0;
+            fade_->step();
+            if (fade_->done()) endFade();
+            return fds_[k].fd >= 0;
+        case LAIpcOp::Off:        rep.ok = kb_.off(); break;
+        case LAIpcOp::Brightness: rep.ok = kb_.setBrightnessOnly(req.level); break;
+        case LAIpcOp::ReadState:
+            rep.ok = req.level ? kb_.requestedState(rep.state) : kb_.readState(rep.state);
+            break;
+        case LAIpcOp::Stats:      rep.ok = 1; break;
+    }
+    if (!laSendAll(fd, &rep, sizeof(rep))) return false;
+
+    if (req.op == LAIpcOp::Stats) {
+        LAIpcStats st{kb_.txCounters(), kb_.ioStats()};
+        if (req.level) kb_.resetIoStats();
+        return laSendAll(fd, &st, sizeof(st));
+    }
+    return true;
+}
+
+void LAIpcServer::endFade() {
+    LAIpcReply rep;
+    rep.ok = fade_->ok();
+    for (auto& p : fds_) {
+        if (fadeFd_ < 0 || p.fd != fadeFd_) continue;
+        if (laSendAll(p.fd, &rep, sizeof(rep))) {
+            p.events = POLLIN;
+        } else {
+            ::close(p.fd);
+            p.fd = -1;
+        }
+    }
+    fade_.reset();
+    fadeFd_ = -1;
+}
+
+bool LAIpcServer::serveOnce(int timeoutMs) {
+    if (fds_.empty()) return false;
+
+    if (fade_) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(fade_->due() - LATransition::Clock::now());
+        int ms = (int)std::max<long long>(0, left.count());
+        timeoutMs = timeoutMs < 0 ? ms : std::min(timeoutMs, ms);
+    }
+
+    for (auto& p : fds_) p.revents = 0;
+    int n = ::poll(fds_.data(), fds_.size(), timeoutMs);
+    if (n < 0) return errno == EINTR;
+
+    if (fade_ && LATransition::Clock::now() >= fade_->due()) {
+        fade_->step();
+        if (fade_->done()) endFade();
+    }
+
+    for (size_t k = 1; k < fds_.size(); ++k) {
+        if (!fds_[k].revents || fds_[k].fd < 0) continue;
+
+        // One request per wakeup; poll() comes straight back if more are queued
+        ReadResult r = (fds_[k].revents & POLLIN) ? readRequest(fds_[k].fd, conns_[k])
+                                                  : ReadResult::Closed;
+        bool alive = r == ReadResult::Partial ||
+                     (r == ReadResult::Complete && reply(k));
+        if (!alive && fds_[k].fd >= 0) {
+            if (fds_[k].fd == fadeFd_) fadeFd_ = -1;   // the fade itself carries on
+            ::close(fds_[k].fd);
+            fds_[k].fd = -1;
+        }
+    }
+    for (size_t k = fds_.size(); k-- > 1;) {
+        if (fds_[k].fd >= 0) continue;
+        fds_.erase(fds_.begin() + (long)k);
+        conns_.erase(conns_.begin() + (long)k);
+    }
+
+    if (fds_[0].revents & POLLIN) {
+        int cfd = ::accept4(fds_[0].fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (cfd >= 0) {
+            fds_.push_back(pollfd{cfd, POLLIN, 0});
+            conns_.emplace_back();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,147 @@
+// LegionAura/lib/ipc.h
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include "legionaura.h"
+
+// ------------------------------------------------------
+// Local socket protocol between legionaurad and its clients.
+// Both ends are built from the same tree, so requests and
+// replies are fixed-size structs sent as-is over SOCK_STREAM.
+// ------------------------------------------------------
+constexpr uint32_t LA_IPC_MAGIC = 0x4C410005; // "LA" + protocol version 5
+
+enum class LAIpcOp : uint8_t {
+    Ping       = 0,
+    Apply      = 1,
+    Off        = 2,
+    Brightness = 3,
+    ReadState  = 4,
+    Transition = 5,
+    Stats      = 6    // reply is followed by an LAIpcStats
+};
+
+struct LAIpcRequest {
+    uint32_t magic = LA_IPC_MAGIC;
+    LAIpcOp  op    = LAIpcOp::Ping;
+    uint8_t  level = 0;          // Brightness only; Stats: 1 = reset after reading;
+                                 // ReadState: 1 = as requested, see LegionAura::requestedState
+    uint8_t  percent = 100;      // Apply/Transition: software brightness, see color.h
+    uint32_t fadeMs = 0;         // Transition only
+    LAParams params{};           // Apply/Transition
+};
+
+// Longest fade the daemon will run; it serves clients one at a time
+constexpr uint32_t LA_IPC_MAX_FADE_MS = 60000;
+
+// Magic, op and the fields that op uses are in range. The daemon drops
+// clients that send anything else.
+bool laIpcRequestValid(const LAIpcRequest& req);
+
+struct LAIpcReply {
+    uint32_t magic = LA_IPC_MAGIC;
+    uint8_t  ok    = 0;
+    LAParams state{};            // ReadState only
+};
+
+struct LAIpcStats {
+    LATxCounters tx;
+    LAIoStats io;
+};
+
+// A root daemon's socket. The directory is root's, so nobody else can
+// put a socket there first.
+constexpr const char* LA_SYSTEM_SOCKET = "/run/legionaura/legionaura.sock";
+
+// Where legionaurad listens: $LEGIONAURA_SOCKET, else LA_SYSTEM_SOCKET
+// when run as root, else $XDG_RUNTIME_DIR/legionaura.sock. Empty when
+// none applies; such a daemon needs --socket.
+std::string laSocketPath();
+
+// Where clients look, in order: $LEGIONAURA_SOCKET alone if it is set,
+// else the user's own daemon, then the system one
+std::vector<std::string> laSocketCandidates();
+
+// Blocking helpers that loop over short reads/writes.
+bool laSendAll(int fd, const void* buf, size_t len);
+bool laRecvAll(int fd, void* buf, size_t len);
+
+// ------------------------------------------------------
+// Client side: mirrors the LegionAura calls, forwarded to the daemon
+// ------------------------------------------------------
+class LAClient {
+public:
+    LAClient() = default;
+    ~LAClient();
+    LAClient(const LAClient&) = delete;
+    LAClient& operator=(const LAClient&) = delete;
+
+    bool connect();                         // first of laSocketCandidates() that answers
+    bool connect(const std::string& path); // false if no daemon is listening
+    void close();
+    bool connected() const { return fd_ >= 0; }
+
+    bool apply(const LAParams& p, uint8_t percent = 100);
+    bool transition(const LAParams& p, uint32_t fadeMs, uint8_t percent = 100); // returns when the fade ends
+    bool off();
+    bool setBrightnessOnly(uint8_t level);
+    bool readState(LAParams& out);
+    bool requestedState(LAParams& out);
+    bool stats(LAIpcStats& out, bool reset = false);
+
+private:
+    bool transact(const LAIpcRequest& req, LAIpcReply& rep);
+
+    int fd_ = -1;
+};
+
+// ------------------------------------------------------
+// Server side: what legionaurad runs. Client sockets are non-blocking
+// and each keeps its own partial request, so a client that sends half
+// a request and stops only stalls itself. Requests are served in turn.
+//
+// A transition doesn't hold the loop: its frames go out from poll()
+// timeouts (see LATransition), other clients are served in between, and
+// its client gets the reply when the fade ends. A later request that
+// changes the lighting ends a running fade where it is (latest wins),
+// and replies to the fade's client first.
+// ------------------------------------------------------
+class LAIpcServer {
+public:
+    explicit LAIpcServer(LegionAura& kb) : kb_(kb) {}
+    ~LAIpcServer();
+    LAIpcServer(const LAIpcServer&) = delete;
+    LAIpcServer& operator=(const LAIpcServer&) = delete;
+
+    // Binds path (mode 0666), replacing a stale socket left by a crash
+    bool listen(const std::string& path, std::string& err);
+    void close();   // drops every client and unlinks the socket
+
+    // Waits up to timeoutMs (-1 = no limit), or less when a fade frame is
+    // due, and serves at most one request per client. False only if
+    // poll() itself fails.
+    bool serveOnce(int timeoutMs);
+    size_t clients() const { return fds_.empty() ? 0 : fds_.size() - 1; }
+
+private:
+    struct Conn {
+        LAIpcRequest req;
+        size_t got = 0;    // bytes of req received so far
+    };
+    enum class ReadResult { Partial, Complete, Closed };
+
+    ReadResult readRequest(int fd, Conn& c);
+    bool reply(size_t k);   // to conns_[k].req; false drops the client
+    void endFade();         // replies to the client that started fade_
+
+
+    LegionAura& kb_;
+    std::string path_;
+    std::vector<pollfd> fds_;    // [0] is the listening socket
+    std::vector<Conn> conns_;    // parallel to fds_
+    std::unique_ptr<LATransition> fade_;
+    int fadeFd_ = -1;            // client waiting for fade_, -1 once it left
+};
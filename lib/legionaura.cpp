@@ -2,22 +2,36 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <string>
 
 #include "legionaura.h"
+#include "async_transfer.h"
+#include "color.h"
+#include "device_table.h"
+#include "frame_mailbox.h"
+#include "io_stats.h"
+#include "packet.h"
 #include <iostream>
+#include <sys/stat.h>
 
 static uint8_t clampByte(int v){ return (uint8_t)std::max(0,std::min(255,v)); }
 
+// Every control transfer uses the same timeout; the I/O stats count how
+// often it is hit (result "timeout")
+static constexpr unsigned kTransferTimeoutMs = 1000;
 
-LegionAura::LegionAura(uint16_t vid, uint16_t pid) : vid_(vid), pid_(pid) {}
+
+LegionAura::LegionAura(uint16_t vid, uint16_t pid)
+    : vid_(vid), pid_(pid), mailbox_(std::make_unique<LAFrameMailbox>()),
+      color_(std::make_unique<LAColorPipeline>()) {}
 LegionAura::~LegionAura(){ close(); }
 
 bool LegionAura::open() {
-    if (ctx_) return true;
+    if (ctx_ || transport_) return true;
 
     if (libusb_init(&ctx_) != 0) {
         std::cerr << "libusb initialization failed.\n";
@@ -46,11 +60,7 @@ bool LegionAura::open() {
     }
 
     // Permission OK, now try interface
-    if (libusb_kernel_driver_active(dev_, iface_) == 1)
-        libusb_detach_kernel_driver(dev_, iface_);
-
-    int claim = libusb_claim_interface(dev_, iface_);
-    if (claim != 0) {
+    if (!claim(dev_)) {
         std::cerr <<
             "Failed to claim USB interface. This usually means:\n"
             "  • Another program is using the device\n"
@@ -64,11 +74,30 @@ bool LegionAura::open() {
         return false;
     }
 
+    setColorProfile(LAColorProfile::forDevice(vid_, pid_));
+    seedShadow();
     return true;
 }
 
 
+bool LegionAura::openWith(std::unique_ptr<LATransport> transport) {
+    close();
+    if (!transport) return false;
+
+    transport_ = std::move(transport);
+    seedShadow();
+    return true;
+}
+
 void LegionAura::close() {
+    disableHotplug();
+    stopWriter();   // sends whatever was last posted
+
+    // Drain pending async transfers before the handle goes away
+    async_.reset();
+    transport_.reset();
+    invalidateShadow();
+
     if (!ctx_) return;
 
     if (dev_) {
@@ -77,7 +106,8 @@ void LegionAura::close() {
     }
     dev_ = nullptr;
 
-    libusb_exit(ctx_);
+    if (sharedCtx_) sharedCtx_.reset();
+    else libusb_exit(ctx_);
     ctx_ = nullptr;
 }
 
@@ -92,23 +122,64 @@ LegionAura::loadSupportedDevices(const std::string& path)
 
     std::stringstream buffer;
     buffer << f.rdbuf();
-    std::string content = buffer.str();
 
-    // raw-string with safe delimiter
-    std::regex pidRegex(R"REGEX("pid"\s*:\s*"0x([0-9A-Fa-f]+)")REGEX");
+    std::vector<LADeviceInfo> devices;
+    std::deque<std::string> names;
+    LADeviceRegistry::parseDevicesFile(buffer.str(), devices, names);
 
-    auto begin = std::sregex_iterator(content.begin(), content.end(), pidRegex);
-    auto end   = std::sregex_iterator();
+    for (auto& d : devices) list.emplace_back(d.vid, d.pid);
+    return list;
+}
 
-    const uint16_t VID = 0x048D;
+// Warm-start cache: where the keyboard was found last time
+// ($XDG_CACHE_HOME/legionaura/last-device, one line "bus ports vid pid")
+struct LACachedDevice {
+    int bus = -1;
+    std::string ports;
+    uint16_t vid = 0, pid = 0;
+};
+
+static std::string deviceCacheDir() {
+    if (const char* x = std::getenv("XDG_CACHE_HOME"); x && *x) return std::string(x) + "/legionaura";
+    if (const char* h = std::getenv("HOME"); h && *h) return std::string(h) + "/.cache/legionaura";
+    return "";
+}
 
-    for (auto it = begin; it != end; ++it) {
-        std::string hex = (*it)[1];
-        uint16_t pid = (uint16_t)std::stoi(hex, nullptr, 16);
-        list.emplace_back(VID, pid);
-    }
+static std::optional<LACachedDevice> readDeviceCache() {
+    std::string dir = deviceCacheDir();
+    if (dir.empty()) return std::nullopt;
 
-    return list;
+    std::ifstream f(dir + "/last-device");
+    LACachedDevice c;
+    unsigned vid = 0, pid = 0;
+    if (!(f >> c.bus >> c.ports >> std::hex >> vid >> pid)) return std::nullopt;
+    c.vid = (uint16_t)vid; c.pid = (uint16_t)pid;
+    return c;
+}
+
+static void writeDeviceCache(const LACachedDevice& c) {
+    std::string dir = deviceCacheDir();
+    if (dir.empty()) return;
+
+    // Best effort: parent of the cache dir may not exist yet either
+    ::mkdir(dir.substr(0, dir.rfind('/')).c_str(), 0755);
+    ::mkdir(dir.c_str(), 0755);
+
+    std::ofstream f(dir + "/last-device", std::ios::trunc);
+    char ids[16];
+    std::snprintf(ids, sizeof(ids), "%04x %04x", c.vid, c.pid);
+    f << c.bus << ' ' << c.ports << ' ' << ids << '\n';
+}
+
+static std::string portPath(libusb_device* d) {
+    uint8_t ports[8];
+    int n = libusb_get_port_numbers(d, ports, sizeof(ports));
+    std::string s;
+    for (int k = 0; k < n; ++k) {
+        if (k) s += '.';
+        s += std::to_string(ports[k]);
+    }
+    return s.empty() ? "0" : s;
 }
 
 bool LegionAura::autoDetect() {
@@ -118,181 +189,451 @@ bool LegionAura::autoDetect() {
         createdCtx = true;
     }
 
-    auto devices = loadSupportedDevices(std::string(PROJECT_SOURCE_DIR) + "/devices/devices.json");
-
-    if (devices.empty()) {
+    // One bus enumeration; each descriptor is checked against the
+    // device table's hash index instead of re-scanning the bus per PID.
+    libusb_device** list = nullptr;
+    ssize_t n = libusb_get_device_list(ctx_, &list);
+    if (n < 0) {
         if (createdCtx) { libusb_exit(ctx_); ctx_ = nullptr; }
         return false;
     }
 
-    for (auto& vp : devices) {
-        uint16_t vid = vp.first, pid = vp.second;
-        libusb_device_handle* h = libusb_open_device_with_vid_pid(ctx_, vid, pid);
-        if (!h) continue;
+    const auto& registry = LADeviceRegistry::instance();
+    auto cached = readDeviceCache();
+
+    struct Candidate { libusb_device* dev; libusb_device_descriptor desc; };
+    std::vector<Candidate> matches;
+
+    for (ssize_t k = 0; k < n; ++k) {
+        libusb_device_descriptor desc;
+        if (libusb_get_device_descriptor(list[k], &desc) != 0) continue;
+        if (!registry.find(desc.idVendor, desc.idProduct)) continue;
+
+        bool warm = cached && cached->vid == desc.idVendor && cached->pid == desc.idProduct &&
+                    cached->bus == libusb_get_bus_number(list[k]) && cached->ports == portPath(list[k]);
+        if (warm) matches.insert(matches.begin(), Candidate{list[k], desc});
+        else      matches.push_back(Candidate{list[k], desc});
+    }
+
+    bool found = false;
+    for (auto& c : matches) {
+        libusb_device_handle* h = nullptr;
+        if (libusb_open(c.dev, &h) != 0) continue;
 
-        // Try to prepare the interface
-        if (libusb_kernel_driver_active(h, iface_) == 1)
-            libusb_detach_kernel_driver(h, iface_);
+        if (adopt(h, c.desc.idVendor, c.desc.idProduct)) {
+            LACachedDevice last{libusb_get_bus_number(c.dev), portPath(c.dev), vid_, pid_};
+            if (!cached || cached->bus != last.bus || cached->ports != last.ports ||
+                cached->vid != last.vid || cached->pid != last.pid)
+                writeDeviceCache(last);
 
-        if (libusb_claim_interface(h, iface_) == 0) {
-            // success: adopt this handle
-            vid_ = vid; pid_ = pid; dev_ = h;
-            return true;
+            found = true;
+            break;
         }
 
         libusb_close(h);
     }
 
+    libusb_free_device_list(list, 1);
+    if (found) return true;
+
     if (createdCtx) { libusb_exit(ctx_); ctx_ = nullptr; }
     return false;
 }
 
 
+// DEVICE GROUPS ----------------------------------------------------
+
+std::string LAUsbDevice::id() const {
+    return std::to_string(bus) + ":" + std::to_string(addr);
+}
+
+bool LAUsbDevice::parseId(const std::string& s, uint8_t& bus, uint8_t& addr) {
+    auto c = s.find(':');
+    if (c == std::string::npos || c == 0 || c + 1 == s.size()) return false;
+    char* end = nullptr;
+    long b = std::strtol(s.c_str(), &end, 10);
+    if (end != s.c_str() + c || b < 0 || b > 255) return false;
+    long a = std::strtol(s.c_str() + c + 1, &end, 10);
+    if (*end != '\0' || a < 0 || a > 255) return false;
+    bus = (uint8_t)b; addr = (uint8_t)a;
+    return true;
+}
+
+std::vector<LAUsbDevice> LegionAura::listDevices() {
+    std::vector<LAUsbDevice> out;
+    libusb_context* ctx = nullptr;
+    if (libusb_init(&ctx) != 0) return out;
+
+    libusb_device** list = nullptr;
+    ssize_t n = libusb_get_device_list(ctx, &list);
+    const auto& registry = LADeviceRegistry::instance();
+    for (ssize_t k = 0; k < n; ++k) {
+        libusb_device_descriptor desc;
+        if (libusb_get_device_descriptor(list[k], &desc) != 0) continue;
+        if (!registry.find(desc.idVendor, desc.idProduct)) continue;
+        out.push_back(LAUsbDevice{libusb_get_bus_number(list[k]), libusb_get_device_address(list[k]),
+                                  desc.idVendor, desc.idProduct});
+    }
+    if (n >= 0) libusb_free_device_list(list, 1);
+    libusb_exit(ctx);
+    return out;
+}
+
+std::vector<std::pair<LAUsbDevice, std::unique_ptr<LegionAura>>> LegionAura::openEvery() {
+    std::vector<std::pair<LAUsbDevice, std::unique_ptr<LegionAura>>> out;
+    libusb_context* raw = nullptr;
+    if (libusb_init(&raw) != 0) return out;
+    std::shared_ptr<libusb_context> ctx(raw, libusb_exit);
+
+    libusb_device** list = nullptr;
+    ssize_t n = libusb_get_device_list(raw, &list);
+    const auto& registry = LADeviceRegistry::instance();
+    for (ssize_t k = 0; k < n; ++k) {
+        libusb_device_descriptor desc;
+        libusb_device_handle* h = nullptr;
+        if (libusb_get_device_descriptor(list[k], &desc) != 0) continue;
+        if (!registry.find(desc.idVendor, desc.idProduct)) continue;
+        if (libusb_open(list[k], &h) != 0) continue;
+
+        auto kb = std::make_unique<LegionAura>();
+        kb->ctx_ = raw;
+        kb->sharedCtx_ = ctx;
+        if (!kb->adopt(h, desc.idVendor, desc.idProduct)) { libusb_close(h); continue; }
+        out.emplace_back(LAUsbDevice{libusb_get_bus_number(list[k]), libusb_get_device_address(list[k]),
+                                     desc.idVendor, desc.idProduct}, std::move(kb));
+    }
+    if (n >= 0) libusb_free_device_list(list, 1);
+    return out;
+}
+
+bool LegionAura::openAt(uint8_t bus, uint8_t addr) {
+    if (ctx_ || transport_) return false;
+    if (libusb_init(&ctx_) != 0) return false;
+
+    libusb_device** list = nullptr;
+    ssize_t n = libusb_get_device_list(ctx_, &list);
+    bool found = false;
+    for (ssize_t k = 0; k < n && !found; ++k) {
+        if (libusb_get_bus_number(list[k]) != bus || libusb_get_device_address(list[k]) != addr) continue;
+
+        libusb_device_descriptor desc;
+        libusb_device_handle* h = nullptr;
+        if (libusb_get_device_descriptor(list[k], &desc) != 0 ||
+            !LADeviceRegistry::instance().find(desc.idVendor, desc.idProduct) ||
+            libusb_open(list[k], &h) != 0)
+            break;
+
+        found = adopt(h, desc.idVendor, desc.idProduct);
+        if (!found) libusb_close(h);
+    }
+    if (n >= 0) libusb_free_device_list(list, 1);
+
+    if (!found) { libusb_exit(ctx_); ctx_ = nullptr; }
+    return found;
+}
+
+bool LegionAura::adopt(libusb_device_handle* h, uint16_t vid, uint16_t pid) {
+    if (!claim(h)) return false;
+    vid_ = vid; pid_ = pid; dev_ = h;
+    setColorProfile(LAColorProfile::forDevice(vid_, pid_));
+    seedShadow();
+    return true;
+}
+
 // --------------------------------------------------------------
 
+bool LegionAura::claim(libusb_device_handle* h) {
+    if (libusb_kernel_driver_active(h, iface_) == 1)
+        libusb_detach_kernel_driver(h, iface_);
+    return libusb_claim_interface(h, iface_) == 0;
+}
+
 bool LegionAura::apply(const LAParams& p) {
-    auto payload = buildPayload(p);
-    return ctrlSendCC(payload);
+    setRequested(p);
+    return send(laEncode(corrected(p)));
 }
 
-bool LegionAura::off() {
-    LAParams p{LAEffect::Static, 1, 1, {}, LAWaveDir::None};
-    p.zones = {LAColor{0,0,0}, LAColor{0,0,0}, LAColor{0,0,0}, LAColor{0,0,0}};
-    return apply(p);
+// --------------------------------------------------------------
+
+void LegionAura::setColorProfile(const LAColorProfile& profile) {
+    std::lock_guard<std::mutex> lk(colorMtx_);
+    color_->setProfile(profile);
 }
 
-bool LegionAura::setBrightnessOnly(uint8_t level)
-{
-    LAParams cur;
+void LegionAura::setSoftwareBrightness(float percent) {
+    std::lock_guard<std::mutex> lk(colorMtx_);
+    color_->setBrightness(percent);
+}
 
-    // // Read current state
-    // if (!readState(cur)) {
-    //     return false;
-    // }
-
-    // // Modify only brightness
-    // cur.brightness = std::max<uint8_t>(1, std::min<uint8_t>(2, level));
-
-    cur.effect = LAEffect::Static;
-    cur.speed = 1;
-    cur.brightness = std::max<uint8_t>(1, std::min<uint8_t>(2, level));
-    cur.zones = {
-        LAColor{255,255,255},
-        LAColor{255,255,255},
-        LAColor{255,255,255},
-        LAColor{255,255,255}
-    };
-    cur.waveDir = LAWaveDir::None;
+LAColorPipeline LegionAura::colorPipeline() const {
+    std::lock_guard<std::mutex> lk(colorMtx_);
+    return *color_;
+}
+
+LAParams LegionAura::corrected(const LAParams& p) const {
+    LAParams out = p;
+    std::lock_guard<std::mutex> lk(colorMtx_);
+    if (!color_->isIdentity()) color_->apply(out);
+    return out;
+}
 
+// Raw bytes come with no uncorrected state to remember
+bool LegionAura::sendPacket(const LAPacket& payload) {
+    setRequested(std::nullopt);
+    return send(payload);
+}
+
+bool LegionAura::send(const LAPacket& payload, bool* suppressed) {
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        lastPayload_ = payload;
+    }
+    const bool same = matchesShadow(payload);
+    if (suppressed) *suppressed = same;
+    if (same) return true;
 
-    // Re-apply full packet
-    return apply(cur);
+    bool ok = ctrlSendCC(payload);
+    recordSent(payload, ok);
+    return ok;
 }
 
+bool LegionAura::applyEncoded(const LAPacket& payload) {
+    bool identity;
+    {
+        std::lock_guard<std::mutex> lk(colorMtx_);
+        identity = color_->isIdentity();
+    }
+    LAParams p;
+    if (!laDecode(payload.data(), payload.size(), p)) return false;
+    if (!identity) return apply(p);
+
+    setRequested(p);
+    return send(payload);
+}
 
+void LegionAura::setRequested(std::optional<LAParams> p) {
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    requested_ = p;
+}
 
-std::vector<uint8_t> LegionAura::buildPayload(const LAParams& p) {
-    LAEffect eff = p.effect;
-    // Only valid effects should be sent. If LAEffect::None leaks in,
-    // reuse Static as a safe default (we never call buildPayload with None from CLI flow).
-    if (!(eff == LAEffect::Static || eff == LAEffect::Breath ||
-          eff == LAEffect::Wave   || eff == LAEffect::Hue)) {
-        eff = LAEffect::Static;
+bool LegionAura::requestedState(LAParams& out) {
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        if (requested_) { out = *requested_; return true; }
+    }
+    // Only the device to go on, which is exact only when nothing is corrected
+    {
+        std::lock_guard<std::mutex> lk(colorMtx_);
+        if (!color_->isIdentity()) return false;
     }
+    return currentColors(out);
+}
 
-    uint8_t speed = std::max<uint8_t>(1, std::min<uint8_t>(4, p.speed));
-    uint8_t bright = std::max<uint8_t>(1, std::min<uint8_t>(2, p.brightness));
+std::future<bool> LegionAura::applyAsync(const LAParams& p) {
+    auto done = std::make_shared<std::promise<bool>>();
+    auto fut = done->get_future();
+    applyAsync(p, [done](bool ok){ done->set_value(ok); });
+    return fut;
+}
 
-    std::vector<uint8_t> d;
-    d.reserve(32);
-    d.push_back(0xCC);
-    d.push_back(0x16);
-    d.push_back(static_cast<uint8_t>(eff));
-    d.push_back(speed);
-    d.push_back(bright);
+bool LegionAura::applyAsync(const LAParams& p, std::function<void(bool ok)> done) {
+    if (!isOpen()) {
+        if (done) done(false);
+        return false;
+    }
 
-    bool needsColors = (eff == LAEffect::Static || eff == LAEffect::Breath);
-    if (needsColors) {
-        for (auto& z : p.zones) { d.push_back(z.r); d.push_back(z.g); d.push_back(z.b); }
-    } else {
-        d.insert(d.end(), 12, 0x00);
+    const LAPacket payload = laEncode(corrected(p));
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        lastPayload_ = payload;
+        requested_ = p;
+    }
+    if (matchesShadow(payload)) {
+        if (done) done(true);
+        return true;
     }
 
-    d.push_back(0x00); // unused
+    // Custom transports have no libusb event loop; complete inline
+    if (transport_) {
+        bool ok = ctrlSendCC(payload);
+        recordSent(payload, ok);
+        if (done) done(ok);
+        return ok;
+    }
 
-    uint8_t rtl=0, ltr=0;
-    if (eff == LAEffect::Wave) {
-        if (p.waveDir == LAWaveDir::RTL) rtl = 1;
-        else if (p.waveDir == LAWaveDir::LTR) ltr = 1;
+    std::lock_guard<std::mutex> io(ioMtx_);
+    if (!dev_) {
+        if (done) done(false);
+        return false;
     }
-    d.push_back(rtl);
-    d.push_back(ltr);
+    if (!async_) async_ = std::make_unique<LAAsyncEngine>(ctx_, dev_);
+
+    return async_->submit(payload.data(), payload.size(),
+        [this, payload, done = std::move(done)](bool ok) {
+            recordSent(payload, ok);
+            if (done) done(ok);
+        });
+}
+
+// SHADOW STATE ----------------------------------------------------
+
+bool LegionAura::matchesShadow(const LAPacket& payload) {
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    if (!shadowValid_ || shadow_ != payload) return false;
+    counters_.suppressed++;
+    return true;
+}
 
-    if (d.size() < 32) d.insert(d.end(), 32 - d.size(), 0x00);
-    return d;
+void LegionAura::recordSent(const LAPacket& payload, bool ok) {
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    if (ok) {
+        shadow_ = payload;
+        shadowValid_ = true;
+        counters_.sent++;
+    } else {
+        // Unknown what the device ended up showing; resend next time
+        shadowValid_ = false;
+    }
 }
 
+void LegionAura::seedShadow() {
+    if (!seedShadow_) return;
 
-bool LegionAura::ctrlSendCC(const std::vector<uint8_t>& data) {
-    if (!dev_) return false;
+    LAParams cur;
+    if (!readState(cur)) return;
 
-    int r = libusb_control_transfer(
-        dev_,
-        0x21,
-        0x09,
-        0x03CC,
-        0x00,
-        const_cast<unsigned char*>(data.data()),
-        (uint16_t)data.size(),
-        1000
-    );
+    // Only trust states we can re-encode byte-for-byte
+    if (!laIsValidEffect(cur.effect)) return;
 
-    return r == (int)data.size();
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    shadow_ = laEncode(cur);
+    shadowValid_ = true;
 }
 
-bool LegionAura::readState(LAParams& out)
-{
-    if (!dev_) return false;
-
-    std::vector<uint8_t> buf(64);
-    int r = libusb_control_transfer(
-        dev_, 0xA1, 0x01, 0x03CC, 0x0000,
-        buf.data(), (uint16_t)buf.size(), 1000
-    );
-    if (r < 20) return false; // need at least up to direction bytes
-
-    out.effect     = static_cast<LAEffect>(buf[2]);
-    out.speed      = buf[3];
-    out.brightness = buf[4];
-
-    if (out.effect == LAEffect::Static || out.effect == LAEffect::Breath) {
-        // need 5..(5+12-1) available
-        if (r < 17) return false;
-        for (int i = 0; i < 4; i++) {
-            out.zones[i].r = buf[5  + i*3 + 0];
-            out.zones[i].g = buf[5  + i*3 + 1];
-            out.zones[i].b = buf[5  + i*3 + 2];
-        }
+void LegionAura::invalidateShadow() {
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    shadowValid_ = false;
+}
+
+LATxCounters LegionAura::txCounters() const {
+    std::lock_guard<std::mutex> lk(shadowMtx_);
+    return counters_;
+}
+
+LAIoStats LegionAura::ioStats() const {
+    return ioStats_.snapshot();
+}
+
+void LegionAura::resetIoStats() {
+    ioStats_.reset();
+}
+
+// Black stays black through any color correction
+bool LegionAura::off() {
+    LAParams p;
+    laDecode(kLAPacketOff.data(), kLAPacketOff.size(), p);
+    setRequested(p);
+    return send(kLAPacketOff);
+}
+
+LAPacket LegionAura::buildPayload(const LAParams& p) {
+    return laEncode(p);
+}
+
+
+static uint64_t usSince(std::chrono::steady_clock::time_point t0) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - t0).count();
+}
+
+bool LegionAura::ctrlSendCC(const LAPacket& data) {
+    int r;
+    uint64_t us;
+    if (transport_) {
+        auto t0 = std::chrono::steady_clock::now();
+        r = transport_->setReport(data.data(), (uint16_t)data.size(), kTransferTimeoutMs);
+        us = usSince(t0);
     } else {
-        for (auto& z : out.zones) z = LAColor{0,0,0};
+        std::lock_guard<std::mutex> io(ioMtx_);
+        if (!dev_) return false;
+
+        auto t0 = std::chrono::steady_clock::now();
+        r = libusb_control_transfer(
+            dev_,
+            0x21,
+            0x09,
+            0x03CC,
+            0x00,
+            const_cast<unsigned char*>(data.data()),
+            (uint16_t)data.size(),
+            kTransferTimeoutMs
+        );
+        us = usSince(t0);
     }
 
-    if (out.effect == LAEffect::Wave) {
-        uint8_t rtl = buf[18], ltr = buf[19];
-        out.waveDir = rtl ? LAWaveDir::RTL : (ltr ? LAWaveDir::LTR : LAWaveDir::None);
+    const bool ok = r == (int)data.size();
+    ioStats_.record(LAIoOp::SetReport, ok ? 0 : (r < 0 ? r : LA_IO_SHORT), us);
+
+    // Round trip feeds transition()'s frame spacing (EWMA, 1/8 weight)
+    if (ok) {
+        uint32_t prev = rttUs_.load();
+        rttUs_.store(prev ? prev - prev / 8 + (uint32_t)us / 8 : (uint32_t)us);
+    }
+    return ok;
+}
+
+bool LegionAura::readState(LAParams& out)
+{
+    std::array<uint8_t,64> buf;
+    int r;
+    uint64_t us;
+    if (transport_) {
+        auto t0 = std::chrono::steady_clock::now();
+        r = transport_->getReport(buf.data(), (uint16_t)buf.size(), kTransferTimeoutMs);
+        us = usSince(t0);
     } else {
-        out.waveDir = LAWaveDir::None;
+        std::lock_guard<std::mutex> io(ioMtx_);
+        if (!dev_) return false;
+
+        auto t0 = std::chrono::steady_clock::now();
+        r = libusb_control_transfer(
+            dev_, 0xA1, 0x01, 0x03CC, 0x0000,
+            buf.data(), (uint16_t)buf.size(), kTransferTimeoutMs
+        );
+        us = usSince(t0);
     }
 
-    // Clamp
-    if (out.speed < 1 || out.speed > 4) out.speed = 1;
-    if (out.brightness < 1 || out.brightness > 2) out.brightness = 1;
+    // Feature reports may legitimately come back shorter than the buffer;
+    // too short to decode counts as a short transfer
+    const bool full = r >= (int)(LA_OFF_LTR + 1);
+    ioStats_.record(LAIoOp::GetReport, r < 0 ? r : (full ? 0 : LA_IO_SHORT), us);
+    if (r < 0) return false;
 
-    return true;
+    return laDecode(buf.data(), (size_t)r, out);
 }
 
 
 
+// ------------------------------------------------------
+// Normalize colors (1->4, 2->4, 3->4, >4->trim)
+// ------------------------------------------------------
+std::vector<std::string> LegionAura::normalizeColors(const std::vector<std::string>& in) {
+    if (in.empty()) return in;
+    std::vector<std::string> out = in;
+
+    for (auto& s : out) {
+        std::transform(s.begin(), s.end(), s.begin(),
+                       [](unsigned char c){ return std::tolower(c); });
+    }
+
+    if (out.size() == 1) out = {out[0], out[0], out[0], out[0]};
+    else if (out.size() == 2) out = {out[0], out[1], out[1], out[1]};
+    else if (out.size() == 3) out = {out[0], out[1], out[2], out[2]};
+    else if (out.size() > 4) out.resize(4);
+
+    return out;
+}
+
 std::optional<LAColor> LegionAura::parseHexRGB(const std::string& s) {
     if (s.size()!=6) return std::nullopt;
 
@@ -2,10 +2,18 @@
 #pragma once
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 #include <libusb-1.0/libusb.h>
+#include "io_stats.h"
 
 struct LAColor { uint8_t r, g, b; };
 
@@ -29,24 +37,181 @@ struct LAParams {
     LAWaveDir waveDir;
 };
 
+// Field selectors for LegionAura::update(); OR them together
+enum LAField : uint32_t {
+    LA_FIELD_EFFECT     = 1u << 0,
+    LA_FIELD_SPEED      = 1u << 1,
+    LA_FIELD_BRIGHTNESS = 1u << 2,
+    LA_FIELD_WAVE_DIR   = 1u << 3,
+    LA_FIELD_ZONE0      = 1u << 4,   // zone i is LA_FIELD_ZONE0 << i
+    LA_FIELD_ZONE1      = 1u << 5,
+    LA_FIELD_ZONE2      = 1u << 6,
+    LA_FIELD_ZONE3      = 1u << 7,
+    LA_FIELD_ZONES      = 0xFu << 4,
+    LA_FIELD_ALL        = 0xFFu
+};
+
+// Packets actually written vs. skipped because the device already shows them
+struct LATxCounters {
+    uint64_t sent = 0;
+    uint64_t suppressed = 0;
+};
+
+// One supported controller on the bus, addressed like lsusb does
+struct LAUsbDevice {
+    uint8_t bus = 0, addr = 0;
+    uint16_t vid = 0, pid = 0;
+
+    std::string id() const;   // "bus:addr", e.g. "3:7"
+    static bool parseId(const std::string& s, uint8_t& bus, uint8_t& addr);
+};
+
+// Latest-wins streaming (LegionAura::post): frames replaced before the
+// writer thread got to them, and the rate the device actually sustained
+struct LAMailboxCounters {
+    uint64_t posted = 0;
+    uint64_t coalesced = 0;
+    uint64_t written = 0;     // transfers the writer made
+    uint64_t unchanged = 0;   // frames skipped as equal to the shadow state
+    uint64_t failures = 0;
+    double   busySec = 0;     // writer time spent inside transfers
+    double deviceFps() const { return busySec > 0 ? written / busySec : 0; }
+};
+
+// ------------------------------------------------------
+// Pluggable backend for the two feature-report requests the ITE
+// protocol uses. LegionAura talks libusb directly unless one is given
+// to openWith() (simulated devices, alternative kernel interfaces).
+// ------------------------------------------------------
+class LATransport {
+public:
+    virtual ~LATransport() = default;
+    // SET_REPORT 0x03CC. Returns bytes written or a negative libusb error code.
+    virtual int setReport(const uint8_t* data, uint16_t len, unsigned timeoutMs) = 0;
+    // GET_REPORT 0x03CC. Returns bytes read or a negative libusb error code.
+    virtual int getReport(uint8_t* data, uint16_t len, unsigned timeoutMs) = 0;
+};
+
+class LAAsyncEngine;
+class LAFrameMailbox;
+class LAZoneFade;
+class LAColorPipeline;
+struct LAColorProfile;
+
 class LegionAura {
 public:
     LegionAura(uint16_t vid = 0x048D, uint16_t pid = 0xC993);
     ~LegionAura();
 
     bool open();
-    bool autoDetect();   // loads VID/PIDs from devices/devices.json and opens first match
+    bool autoDetect();   // tries every VID/PID in the device table and opens the first match
+    bool openWith(std::unique_ptr<LATransport> transport); // bypass libusb entirely
+    bool openAt(uint8_t bus, uint8_t addr);                 // one specific controller, see listDevices()
+    bool openHidraw(const std::string& root = "");          // kernel hidraw node, no libusb; see hidraw.h
+    static std::vector<LAUsbDevice> listDevices();           // every supported controller, one enumeration
+    // Opens every supported controller from one enumeration; the devices
+    // share a libusb context, which goes away with the last of them.
+    static std::vector<std::pair<LAUsbDevice, std::unique_ptr<LegionAura>>> openEvery();
     void close();
+    bool isOpen() const { return dev_ || transport_; }
 
     bool apply(const LAParams& p);
     bool off();
+    bool sendPacket(const std::array<uint8_t,32>& payload); // pre-encoded, e.g. kLAPacketOff
+    // Pre-encoded but not yet color-corrected (saved profiles): sent as is
+    // when the color pipeline is identity, otherwise decoded and applied.
+    bool applyEncoded(const std::array<uint8_t,32>& payload);
 
-    bool setBrightnessOnly(uint8_t level); // change only brightness, keep current mode/colors
+    // Non-blocking apply: the packet is queued on libusb's async API and
+    // completes on the library's event thread. The callback form returns
+    // false if the transfer could not be submitted (callback is then
+    // invoked with false as well).
+    std::future<bool> applyAsync(const LAParams& p);
+    bool applyAsync(const LAParams& p, std::function<void(bool ok)> done);
+
+    // ----------------------------------------------------
+    // Fade from what the device shows (shadow state, else readState) to
+    // `to`: zone colors are interpolated in OKLab and sent as Static
+    // frames, then `to` itself. Frames are spaced by the measured
+    // SET_REPORT round trip, so a slow controller gets fewer steps rather
+    // than a late finish. Blocks for `duration` (see LATransition for a
+    // fade that doesn't). Applies `to` directly when either end has no
+    // zone colors (Wave/Hue).
+    // ----------------------------------------------------
+    bool transition(const LAParams& to, std::chrono::milliseconds duration);
+    uint32_t transferRttUs() const { return rttUs_.load(); } // smoothed, 0 until the first transfer
+
+    // ----------------------------------------------------
+    // Streaming for producers that may outpace the controller: post()
+    // never blocks; a writer thread (started on first use) always sends
+    // the newest frame and drops the ones it never got to. close() still
+    // sends the last posted frame, and so does flushPosted(); cancelPosted()
+    // drops it instead. Both return with the writer idle: call one before
+    // a synchronous send so a stale frame can't land after it.
+    // ----------------------------------------------------
+    bool post(const LAParams& p);
+    void flushPosted();
+    void cancelPosted();
+    LAMailboxCounters mailboxCounters() const;
+
+    // ----------------------------------------------------
+    // Partial update: only the fields selected in `fields` (LAField bits)
+    // are taken from `p`, the rest keep what the device shows. The merge
+    // is done against the shadow state, so a warm update is one transfer
+    // (none if nothing changes); readState() is used only when the shadow
+    // is cold or was invalidated. Zones the current effect doesn't carry
+    // (Wave/Hue) read back as black.
+    // ----------------------------------------------------
+    bool update(uint32_t fields, const LAParams& p);
+    bool setBrightnessOnly(uint8_t level); // update(LA_FIELD_BRIGHTNESS, ...)
     bool readState(LAParams& out);         // read current device state (effect/speed/brightness/colors)
+    bool currentColors(LAParams& out);     // shadow if valid, else readState
+
+    // ----------------------------------------------------
+    // Shadow state: the last payload the device accepted. apply() skips
+    // transfers whose encoded bytes are identical to it.
+    // ----------------------------------------------------
+    void setSeedShadowOnOpen(bool on) { seedShadow_ = on; } // readState() at open to prime it
+    void invalidateShadow();
+    LATxCounters txCounters() const;
+
+    // The last state asked for through apply(), transition(), update(),
+    // post(), applyEncoded() or off(), before color correction: what a
+    // saved profile should hold. A raw sendPacket() forgets it. Without
+    // one, falls back to the device state, but only while the color
+    // pipeline is identity; false otherwise.
+    bool requestedState(LAParams& out);
+
+    // ----------------------------------------------------
+    // I/O health: latency histograms of every SET_REPORT/GET_REPORT,
+    // split by result (ok, short, libusb error code). See io_stats.h.
+    // ----------------------------------------------------
+    LAIoStats ioStats() const;
+    void resetIoStats();
+
+    // ----------------------------------------------------
+    // Hotplug: watch for the open device leaving and coming back (USB
+    // reset, suspend/resume). On re-arrival the interface is reclaimed
+    // and the last applied packet replayed. onChange runs on the
+    // library's hotplug thread.
+    // ----------------------------------------------------
+    bool enableHotplug(std::function<void(bool connected)> onChange = {});
+    void disableHotplug();
+
+    // ----------------------------------------------------
+    // Color pipeline: every apply() passes the zones through the model's
+    // gamma/white balance (from the device table, loaded on open) and a
+    // 0..100% perceptual software brightness. Identity by default.
+    // ----------------------------------------------------
+    void setColorProfile(const LAColorProfile& profile);
+    void setSoftwareBrightness(float percent);
+    LAColorPipeline colorPipeline() const;     // copy; include color.h to use it
 
     static std::optional<LAColor> parseHexRGB(const std::string& hex); // "RRGGBB"
+    static std::vector<std::string> normalizeColors(const std::vector<std::string>& in); // 1..3 -> 4, >4 -> trim
+    static std::array<uint8_t,32> buildPayload(const LAParams& p);  // SET_REPORT body, see packet.h
     static std::vector<std::pair<uint16_t,uint16_t>>
-    loadSupportedDevices(const std::string& path);
+    loadSupportedDevices(const std::string& path);   // VID/PIDs from a devices.json-style file
 
     // ----------------------------------------------------
     // NEW: Safe accessors for GUI
@@ -55,11 +220,91 @@ public:
     uint16_t getPid() const { return pid_; }
 
 private:
-    std::vector<uint8_t> buildPayload(const LAParams& p);
-    bool ctrlSendCC(const std::vector<uint8_t>& data);
+    friend class LATransition;
+
+    bool ctrlSendCC(const std::array<uint8_t,32>& data);
+    // sendPacket() that keeps requested_; *suppressed says whether the
+    // shadow check skipped the transfer
+    bool send(const std::array<uint8_t,32>& payload, bool* suppressed = nullptr);
+    void setRequested(std::optional<LAParams> p);
+    bool matchesShadow(const std::array<uint8_t,32>& payload);   // counts a suppression on hit
+    void recordSent(const std::array<uint8_t,32>& payload, bool ok);
+    void seedShadow();
+    LAParams corrected(const LAParams& p) const;   // through color_
+    bool claim(libusb_device_handle* h);   // detach kernel driver + claim iface_
+    bool adopt(libusb_device_handle* h, uint16_t vid, uint16_t pid); // claim + per-model setup
+    void writerLoop();
+    void stopWriter();
+
+    static int LIBUSB_CALL onHotplug(libusb_context* ctx, libusb_device* dev,
+                                     libusb_hotplug_event event, void* self);
+    void hotplugLoop();
+    void handleDeviceLeft();
+    void handleDeviceArrived(libusb_device* dev);
 
     uint16_t vid_, pid_;
     libusb_context* ctx_ = nullptr;
+    std::shared_ptr<libusb_context> sharedCtx_;   // openEvery(): released instead of exited
     libusb_device_handle* dev_ = nullptr;
     int iface_ = 0;
+    std::unique_ptr<LATransport> transport_;
+    std::unique_ptr<LAAsyncEngine> async_;   // started on first applyAsync
+
+    mutable std::mutex shadowMtx_;           // async completions update it from the event thread
+    std::array<uint8_t,32> shadow_{};
+    bool shadowValid_ = false;
+    bool seedShadow_ = false;
+    LATxCounters counters_;
+    std::atomic<uint32_t> rttUs_{0};         // EWMA of ctrlSendCC, see transition()
+    LAIoRecorder ioStats_;
+    std::optional<std::array<uint8_t,32>> lastPayload_; // replayed after a reconnect
+    std::optional<LAParams> requested_;      // see requestedState()
+
+    std::unique_ptr<LAFrameMailbox> mailbox_;   // see frame_mailbox.h
+    std::mutex writerMtx_;                   // starting/stopping writer_
+    std::thread writer_;
+    std::atomic<uint64_t> wrWritten_{0}, wrUnchanged_{0}, wrFailures_{0}, wrBusyNs_{0};
+
+    mutable std::mutex colorMtx_;
+    std::unique_ptr<LAColorPipeline> color_;   // see color.h
+
+    std::mutex ioMtx_;                       // dev_/async_ vs. the hotplug thread
+    std::mutex hpMtx_;                       // pending hotplug events
+    libusb_device* usbDev_ = nullptr;        // device behind dev_, for matching "left" events
+    libusb_device* pendingArrival_ = nullptr;
+    bool pendingLeft_ = false;
+    libusb_hotplug_callback_handle hpHandle_{};
+    std::atomic<bool> hpRunning_{false};
+    std::thread hpThread_;
+    std::function<void(bool)> onConnChange_;
+};
+
+// ------------------------------------------------------
+// LegionAura::transition() one frame at a time, for an event loop that
+// can't block for the whole fade: call step() at due(); it sends the
+// frame for that moment (or the final packet) and schedules the next.
+// Frames are paced exactly as transition() paces them.
+// ------------------------------------------------------
+class LATransition {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LATransition(LegionAura& kb, const LAParams& to, std::chrono::milliseconds duration);
+    ~LATransition();
+    LATransition(const LATransition&) = delete;
+    LATransition& operator=(const LATransition&) = delete;
+
+    bool step();                       // false once a transfer has failed
+    bool done() const { return done_; }
+    bool ok() const { return ok_; }    // every transfer so far succeeded
+    Clock::time_point due() const { return due_; }
+
+private:
+    Clock::time_point lastSlot() const;
+
+    LegionAura& kb_;
+    LAParams to_, target_;                // as requested / after correction
+    std::unique_ptr<LAZoneFade> fade_;    // null: step() applies `to` directly
+    Clock::time_point start_, end_, due_;
+    bool done_ = false, ok_ = true;
 };
\ No newline at end of file
@@ -0,0 +1,155 @@
+// LegionAura/lib/packet.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "legionaura.h"
+
+// ------------------------------------------------------
+// ITE 0xCC/0x16 lighting report, encoded and decoded without touching
+// the heap. Everything here is constexpr, so fixed presets are built at
+// compile time and the wire layout is checked by static_asserts below.
+//
+//   [0]     0xCC   report id
+//   [1]     0x16   lighting command
+//   [2]     effect (Static/Breath/Wave/Hue)
+//   [3]     speed 1..4
+//   [4]     brightness 1..2
+//   [5..16] zone 1..4 RGB (Static/Breath only, zero otherwise)
+//   [17]    unused
+//   [18]    RTL, [19] LTR (Wave only)
+//   [20..31] zero
+// ------------------------------------------------------
+using LAPacket = std::array<uint8_t,32>;
+
+constexpr size_t LA_OFF_EFFECT     = 2;
+constexpr size_t LA_OFF_SPEED      = 3;
+constexpr size_t LA_OFF_BRIGHTNESS = 4;
+constexpr size_t LA_OFF_ZONES      = 5;
+constexpr size_t LA_OFF_RTL        = 18;
+constexpr size_t LA_OFF_LTR        = 19;
+
+constexpr bool laIsValidEffect(LAEffect e) {
+    return e == LAEffect::Static || e == LAEffect::Breath ||
+           e == LAEffect::Wave   || e == LAEffect::Hue;
+}
+
+constexpr uint8_t laClamp(uint8_t v, uint8_t lo, uint8_t hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// std::array's operator== is not constexpr before C++20
+constexpr bool laPacketEqual(const LAPacket& a, const LAPacket& b) {
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+constexpr LAPacket laEncode(const LAParams& p) {
+    // Only valid effects should be sent. If LAEffect::None leaks in,
+    // reuse Static as a safe default.
+    LAEffect eff = laIsValidEffect(p.effect) ? p.effect : LAEffect::Static;
+
+    LAPacket d{};
+    d[0] = 0xCC;
+    d[1] = 0x16;
+    d[LA_OFF_EFFECT]     = static_cast<uint8_t>(eff);
+    d[LA_OFF_SPEED]      = laClamp(p.speed, 1, 4);
+    d[LA_OFF_BRIGHTNESS] = laClamp(p.brightness, 1, 2);
+
+    if (eff == LAEffect::Static || eff == LAEffect::Breath) {
+        for (size_t i = 0; i < 4; ++i) {
+            d[LA_OFF_ZONES + i*3 + 0] = p.zones[i].r;
+            d[LA_OFF_ZONES + i*3 + 1] = p.zones[i].g;
+            d[LA_OFF_ZONES + i*3 + 2] = p.zones[i].b;
+        }
+    }
+
+    if (eff == LAEffect::Wave) {
+        if (p.waveDir == LAWaveDir::RTL) d[LA_OFF_RTL] = 1;
+        else if (p.waveDir == LAWaveDir::LTR) d[LA_OFF_LTR] = 1;
+    }
+    return d;
+}
+
+// Inverse of laEncode for GET_REPORT replies. `len` is the number of
+// bytes the device returned; out-of-range speed/brightness read back as 1.
+constexpr bool laDecode(const uint8_t* buf, size_t len, LAParams& out) {
+    if (len < LA_OFF_LTR + 1) return false; // need at least up to direction bytes
+
+    out.effect     = static_cast<LAEffect>(buf[LA_OFF_EFFECT]);
+    out.speed      = buf[LA_OFF_SPEED];
+    out.brightness = buf[LA_OFF_BRIGHTNESS];
+
+    for (size_t i = 0; i < 4; ++i) {
+        if (out.effect == LAEffect::Static || out.effect == LAEffect::Breath)
+            out.zones[i] = LAColor{buf[LA_OFF_ZONES + i*3 + 0],
+                                   buf[LA_OFF_ZONES + i*3 + 1],
+                                   buf[LA_OFF_ZONES + i*3 + 2]};
+        else
+            out.zones[i] = LAColor{0,0,0};
+    }
+
+    out.waveDir = LAWaveDir::None;
+    if (out.effect == LAEffect::Wave) {
+        if (buf[LA_OFF_RTL]) out.waveDir = LAWaveDir::RTL;
+        else if (buf[LA_OFF_LTR]) out.waveDir = LAWaveDir::LTR;
+    }
+
+    // Clamp
+    if (out.speed < 1 || out.speed > 4) out.speed = 1;
+    if (out.brightness < 1 || out.brightness > 2) out.brightness = 1;
+    return true;
+}
+
+// ------------------------------------------------------
+// Precomputed presets
+// ------------------------------------------------------
+inline constexpr LAPacket kLAPacketOff = laEncode(LAParams{
+    LAEffect::Static, 1, 1,
+    {LAColor{0,0,0}, LAColor{0,0,0}, LAColor{0,0,0}, LAColor{0,0,0}},
+    LAWaveDir::None});
+
+inline constexpr LAPacket kLAPacketWhiteLow = laEncode(LAParams{
+    LAEffect::Static, 1, 1,
+    {LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}},
+    LAWaveDir::None});
+
+inline constexpr LAPacket kLAPacketWhiteHigh = laEncode(LAParams{
+    LAEffect::Static, 1, 2,
+    {LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}},
+    LAWaveDir::None});
+
+// ------------------------------------------------------
+// Wire layout checks
+// ------------------------------------------------------
+namespace la_packet_checks {
+
+constexpr LAParams kZones{LAEffect::Breath, 9, 0,
+    {LAColor{1,2,3}, LAColor{4,5,6}, LAColor{7,8,9}, LAColor{10,11,12}}, LAWaveDir::RTL};
+constexpr LAPacket kZonesPkt = laEncode(kZones);
+constexpr LAPacket kWaveRtl  = laEncode(LAParams{LAEffect::Wave, 2, 2, {LAColor{9,9,9}}, LAWaveDir::RTL});
+constexpr LAPacket kWaveLtr  = laEncode(LAParams{LAEffect::Wave, 2, 2, {}, LAWaveDir::LTR});
+constexpr LAPacket kNone     = laEncode(LAParams{LAEffect::None, 1, 1, {}, LAWaveDir::None});
+
+static_assert(kZonesPkt[0] == 0xCC && kZonesPkt[1] == 0x16, "report header");
+static_assert(kZonesPkt[LA_OFF_EFFECT] == 0x03, "effect byte");
+static_assert(kZonesPkt[LA_OFF_SPEED] == 4 && kZonesPkt[LA_OFF_BRIGHTNESS] == 1, "speed/brightness clamping");
+static_assert(kZonesPkt[5] == 1 && kZonesPkt[16] == 12, "zone colors occupy bytes 5..16");
+static_assert(kZonesPkt[17] == 0 && kZonesPkt[LA_OFF_RTL] == 0, "direction only sent for Wave");
+static_assert(kWaveRtl[LA_OFF_RTL] == 1 && kWaveRtl[LA_OFF_LTR] == 0, "RTL is byte 18");
+static_assert(kWaveLtr[LA_OFF_RTL] == 0 && kWaveLtr[LA_OFF_LTR] == 1, "LTR is byte 19");
+static_assert(kWaveRtl[5] == 0, "zone colors zeroed for Wave");
+static_assert(kNone[LA_OFF_EFFECT] == 0x01, "invalid effect falls back to Static");
+static_assert(kLAPacketOff[5] == 0 && kLAPacketWhiteHigh[16] == 0xFF, "presets");
+
+constexpr bool roundTrips() {
+    LAParams d{};
+    if (!laDecode(kZonesPkt.data(), kZonesPkt.size(), d)) return false;
+    return d.effect == LAEffect::Breath && d.speed == 4 && d.brightness == 1 &&
+           d.zones[3].b == 12 && d.waveDir == LAWaveDir::None &&
+           laPacketEqual(laEncode(d), kZonesPkt);
+}
+static_assert(roundTrips(), "decode(encode(p)) must re-encode to the same bytes");
+
+} // namespace la_packet_checks
@@ -0,0 +1,130 @@
+// /LegionAura/lib/profiles.cpp
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+
+#include "profiles.h"
+
+static constexpr char kMagic[4] = {'L', 'A', 'P', 'F'};
+
+struct LAProfilesHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;
+};
+static_assert(sizeof(LAProfilesHeader) == 12, "profiles header layout");
+
+static bool nameLess(const LAProfileEntry& e, const std::string& name) {
+    return std::strncmp(e.name, name.c_str(), sizeof e.name) < 0;
+}
+
+LAProfileStore::LAProfileStore(std::string path) : path_(std::move(path)) {}
+
+std::string LAProfileStore::defaultPath() {
+    if (const char* p = std::getenv("LEGIONAURA_PROFILES"); p && *p) return p;
+    if (const char* x = std::getenv("XDG_CONFIG_HOME"); x && *x) return std::string(x) + "/legionaura/profiles.bin";
+    if (const char* h = std::getenv("HOME"); h && *h) return std::string(h) + "/.config/legionaura/profiles.bin";
+    return "profiles.bin";
+}
+
+bool LAProfileStore::validName(const std::string& name) {
+    if (name.empty() || name.size() > LA_PROFILE_NAME_MAX) return false;
+    return std::none_of(name.begin(), name.end(), [](char c){
+        return c == '/' || (unsigned char)c <= ' ';
+    });
+}
+
+// FILE -------------------------------------------------------------
+
+bool LAProfileStore::load(std::string& err) {
+    entries_.clear();
+    FILE* f = std::fopen(path_.c_str(), "rb");
+    if (!f) return true;   // nothing saved yet
+
+    LAProfilesHeader h{};
+    bool ok = std::fread(&h, sizeof h, 1, f) == 1 &&
+              std::memcmp(h.magic, kMagic, sizeof kMagic) == 0 &&
+              h.version == LA_PROFILES_VERSION && h.count <= 65536;
+    if (ok) {
+        entries_.resize(h.count);
+        ok = std::fread(entries_.data(), sizeof(LAProfileEntry), h.count, f) == h.count;
+    }
+    std::fclose(f);
+
+    // Names must be terminated and the index sorted, or lookups go wrong
+    for (size_t i = 0; ok && i < entries_.size(); ++i) {
+        ok = entries_[i].name[LA_PROFILE_NAME_MAX] == '\0' &&
+             (i == 0 || std::strcmp(entries_[i - 1].name, entries_[i].name) < 0);
+    }
+    if (!ok) {
+        entries_.clear();
+        err = path_ + ": not a profile file or corrupt";
+    }
+    return ok;
+}
+
+bool LAProfileStore::save(std::string& err) const {
+    // Best effort, like the device cache: the parent may not exist either
+    const std::string dir = path_.substr(0, path_.rfind('/'));
+    if (path_.find('/') != std::string::npos) {
+        ::mkdir(dir.substr(0, dir.rfind('/')).c_str(), 0755);
+        ::mkdir(dir.c_str(), 0755);
+    }
+
+    LAProfilesHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof kMagic);
+    h.version = LA_PROFILES_VERSION;
+    h.count   = (uint32_t)entries_.size();
+
+    const std::string tmp = path_ + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) { err = "cannot write " + tmp; return false; }
+    bool ok = std::fwrite(&h, sizeof h, 1, f) == 1;
+    if (ok && !entries_.empty())
+        ok = std::fwrite(entries_.data(), sizeof(LAProfileEntry), entries_.size(), f) == entries_.size();
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        err = "cannot write " + path_;
+        return false;
+    }
+    return true;
+}
+
+// INDEX ------------------------------------------------------------
+
+const LAPacket* LAProfileStore::find(const std::string& name) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), name, nameLess);
+    if (it == entries_.end() || name != it->name) return nullptr;
+    return &it->packet;
+}
+
+bool LAProfileStore::put(const std::string& name, const LAPacket& packet) {
+    if (!validName(name)) return false;
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), name, nameLess);
+    if (it == entries_.end() || name != it->name) {
+        LAProfileEntry e{};
+        std::memcpy(e.name, name.data(), name.size());
+        it = entries_.insert(it, e);
+    }
+    it->packet = packet;
+    return true;
+}
+
+bool LAProfileStore::remove(const std::string& name) {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), name, nameLess);
+    if (it == entries_.end() || name != it->name) return false;
+    entries_.erase(it);
+    return true;
+}
+
+std::vector<std::string> LAProfileStore::names() const {
+    std::vector<std::string> out;
+    out.reserve(entries_.size());
+    for (auto& e : entries_) out.emplace_back(e.name);
+    return out;
+}
@@ -0,0 +1,49 @@
+// LegionAura/lib/profiles.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "packet.h"
+
+// ------------------------------------------------------
+// Named lighting presets, stored as finished packets so switching is a
+// lookup plus one transfer (see LegionAura::applyEncoded). One small
+// file: $LEGIONAURA_PROFILES, else $XDG_CONFIG_HOME/legionaura/profiles.bin:
+//
+//   header   "LAPF", version, count (12 bytes)
+//   entries  LAProfileEntry[count], sorted by name (the index)
+//
+// Packets hold the colors as requested, before the model's color
+// correction and software brightness, which are applied when sending.
+// ------------------------------------------------------
+constexpr uint32_t LA_PROFILES_VERSION = 1;
+constexpr size_t   LA_PROFILE_NAME_MAX = 31;
+
+struct LAProfileEntry {
+    char     name[LA_PROFILE_NAME_MAX + 1];   // NUL-padded
+    LAPacket packet;
+};
+static_assert(sizeof(LAProfileEntry) == 64, "profile entry layout");
+
+class LAProfileStore {
+public:
+    explicit LAProfileStore(std::string path = defaultPath());
+
+    static std::string defaultPath();
+    static bool validName(const std::string& name);   // 1..31 chars, no spaces or '/'
+    const std::string& path() const { return path_; }
+
+    bool load(std::string& err);              // a missing file is an empty store
+    bool save(std::string& err) const;        // creates the directory; temp file + rename
+
+    const LAPacket* find(const std::string& name) const;   // binary search, nullptr if absent
+    bool put(const std::string& name, const LAPacket& packet);   // add or replace
+    bool remove(const std::string& name);
+    std::vector<std::string> names() const;   // sorted
+    size_t size() const { return entries_.size(); }
+
+private:
+    std::vector<LAProfileEntry> entries_;
+    std::string path_;
+};
@@ -0,0 +1,383 @@
+// /LegionAura/lib/reactive.cpp
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "reactive.h"
+
+using Clock = std::chrono::steady_clock;
+
+// steady_clock is CLOCK_MONOTONIC, the clock the event timestamps and
+// the timerfds use
+static double nowSec() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+static double eventSec(const input_event& ev) {
+    return (double)ev.input_event_sec + (double)ev.input_event_usec * 1e-6;
+}
+
+// KEY MAP ----------------------------------------------------------
+
+LAKeyMap LAKeyMap::laptop() {
+    static const uint16_t left[] = {
+        KEY_ESC, KEY_F1, KEY_F2, KEY_F3, KEY_F4,
+        KEY_GRAVE, KEY_1, KEY_2, KEY_3, KEY_4,
+        KEY_TAB, KEY_Q, KEY_W, KEY_E, KEY_R,
+        KEY_CAPSLOCK, KEY_A, KEY_S, KEY_D, KEY_F,
+        KEY_LEFTSHIFT, KEY_102ND, KEY_Z, KEY_X, KEY_C, KEY_V,
+        KEY_LEFTCTRL, KEY_LEFTMETA, KEY_LEFTALT,
+    };
+    static const uint16_t middle[] = {
+        KEY_F5, KEY_F6, KEY_F7, KEY_F8, KEY_F9,
+        KEY_5, KEY_6, KEY_7, KEY_8, KEY_9,
+        KEY_T, KEY_Y, KEY_U, KEY_I, KEY_O,
+        KEY_G, KEY_H, KEY_J, KEY_K, KEY_L,
+        KEY_B, KEY_N, KEY_M, KEY_COMMA,
+        KEY_SPACE,
+    };
+    static const uint16_t right[] = {
+        KEY_F10, KEY_F11, KEY_F12, KEY_SYSRQ, KEY_INSERT, KEY_DELETE,
+        KEY_0, KEY_MINUS, KEY_EQUAL, KEY_BACKSPACE,
+        KEY_P, KEY_LEFTBRACE, KEY_RIGHTBRACE, KEY_BACKSLASH,
+        KEY_SEMICOLON, KEY_APOSTROPHE, KEY_ENTER,
+        KEY_DOT, KEY_SLASH, KEY_RIGHTSHIFT,
+        KEY_RIGHTALT, KEY_RIGHTCTRL, KEY_COMPOSE,
+        KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+    };
+    static const uint16_t numpad[] = {
+        KEY_HOME, KEY_END, KEY_PAGEUP, KEY_PAGEDOWN,
+        KEY_NUMLOCK, KEY_KPSLASH, KEY_KPASTERISK, KEY_KPMINUS,
+        KEY_KP7, KEY_KP8, KEY_KP9, KEY_KPPLUS,
+        KEY_KP4, KEY_KP5, KEY_KP6,
+        KEY_KP1, KEY_KP2, KEY_KP3, KEY_KPENTER,
+        KEY_KP0, KEY_KPDOT,
+    };
+
+    LAKeyMap m;
+    for (auto c : left)   m.set(c, 0);
+    for (auto c : middle) m.set(c, 1);
+    for (auto c : right)  m.set(c, 2);
+    for (auto c : numpad) m.set(c, 3);
+    return m;
+}
+
+bool LAKeyMap::parseOverrides(const std::string& s, LAKeyMap& m) {
+    LAKeyMap out = m;
+    const bool ok = laForEachListItem(s, [&out](const std::string& item) {
+        char* end = nullptr;
+        long code = std::strtol(item.c_str(), &end, 10);
+        if (end == item.c_str() || *end != ':' || code < 0 || code >= kCodes) return false;
+        const char* z = end + 1;
+        long zone = std::strtol(z, &end, 10);
+        if (end == z || *end || zone < 0 || zone > 4) return false;
+        out.set((uint16_t)code, (int)zone - 1);
+        return true;
+    });
+    if (!ok) return false;
+    m = out;
+    return true;
+}
+
+// RENDERER ---------------------------------------------------------
+
+void LAKeyRenderer::hit(int zone, double t) {
+    hits_[next_] = Hit{zone, t};
+    next_ = (next_ + 1) % hits_.size();
+    count_ = std::min(count_ + 1, hits_.size());
+}
+
+double LAKeyRenderer::span() const {
+    return decay_ + (effect_ == LAKeyEffect::Ripple ? 3 * ripple_ : 0.0);
+}
+
+bool LAKeyRenderer::active(double t) const {
+    for (size_t k = 0; k < count_; ++k)
+        if (t - hits_[k].t < span()) return true;
+    return false;
+}
+
+LAZoneFrame LAKeyRenderer::render(double t) const {
+    auto env = [this](double dt) {
+        if (dt < 0 || dt >= decay_) return 0.0;
+        const double x = 1.0 - dt / decay_;
+        return x * x;
+    };
+
+    std::array<double,4> level{};
+    for (size_t k = 0; k < count_; ++k) {
+        const Hit& h = hits_[k];
+        const double dt = t - h.t;
+        switch (effect_) {
+            case LAKeyEffect::Flash:
+                for (auto& l : level) l = std::max(l, env(dt));
+                break;
+            case LAKeyEffect::Ripple:
+                for (int z = 0; z < 4; ++z)
+                    level[z] = std::max(level[z], env(dt - std::abs(z - h.zone) * ripple_));
+                break;
+            case LAKeyEffect::Decay:
+                level[h.zone] += 0.6 * env(dt);
+                break;
+        }
+    }
+
+    LAZoneFrame f;
+    for (int z = 0; z < 4; ++z)
+        f[z] = LAAnimator::lerp(base_, press_[z], std::min(1.0, level[z]));
+    return f;
+}
+
+// INPUT ------------------------------------------------------------
+
+LAKeyReactive::LAKeyReactive(LAKeyRenderer& renderer, const LAKeyMap& map)
+    : renderer_(renderer), map_(map)
+{
+}
+
+LAKeyReactive::~LAKeyReactive() {
+    for (auto& d : devices_) if (d.fd >= 0) ::close(d.fd);
+    if (record_) std::fclose(record_);
+}
+
+static bool hasBit(const uint8_t* bits, int n) { return bits[n / 8] & (1 << (n % 8)); }
+
+std::vector<std::string> LAKeyReactive::findKeyboards() {
+    std::vector<std::string> out;
+    DIR* d = opendir("/dev/input");
+    if (!d) return out;
+    while (dirent* e = readdir(d)) {
+        if (std::strncmp(e->d_name, "event", 5) != 0) continue;
+        const std::string path = std::string("/dev/input/") + e->d_name;
+        int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) continue;
+        uint8_t keys[KEY_MAX / 8 + 1] = {};
+        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof keys), keys) >= 0 &&
+            hasBit(keys, KEY_A) && hasBit(keys, KEY_Z) && hasBit(keys, KEY_SPACE))
+            out.push_back(path);
+        ::close(fd);
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end(), [](const std::string& a, const std::string& b) {
+        return std::atoi(a.c_str() + 16) < std::atoi(b.c_str() + 16);   // after "/dev/input/event"
+    });
+    return out;
+}
+
+bool LAKeyReactive::addDevice(const std::string& path, std::string& err) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        err = path + ": " + std::strerror(errno);
+        if (errno == EACCES) err += " (add yourself to the input group, or run with sudo)";
+        return false;
+    }
+    int clk = CLOCK_MONOTONIC;
+    bool kernelTime = ioctl(fd, EVIOCSCLOCKID, &clk) == 0;
+    devices_.push_back(Device{fd, kernelTime});
+    return true;
+}
+
+bool LAKeyReactive::openReplay(const std::string& path, double speed, std::string& err) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) { err = path + ": " + std::strerror(errno); return false; }
+
+    std::vector<Event> events;
+    input_event ev;
+    size_t got;
+    double t0 = 0;
+    while ((got = std::fread(&ev, 1, sizeof ev, f)) == sizeof ev) {
+        if (ev.type != EV_KEY) continue;
+        if (events.empty()) t0 = eventSec(ev);
+        events.push_back(Event{ev.code, ev.value, std::max(0.0, eventSec(ev) - t0)});
+    }
+    std::fclose(f);
+    if (got != 0) {
+        err = path + ": not a stream of " + std::to_string(sizeof ev) + "-byte input_event records";
+        return false;
+    }
+    replay_ = std::move(events);
+    replaySpeed_ = std::max(0.0, speed);
+    return true;
+}
+
+bool LAKeyReactive::record(const std::string& path, std::string& err) {
+    if (record_) std::fclose(record_);
+    record_ = std::fopen(path.c_str(), "wb");
+    if (!record_) { err = "cannot write " + path; return false; }
+    return true;
+}
+
+void LAKeyReactive::press(const Event& e, LAKeyStats& st) {
+    if (e.value != 1) return;   // releases and autorepeat don't light anything
+    int zone = map_.zone(e.code);
+    if (zone < 0) { st.unmapped++; return; }
+    renderer_.hit(zone, e.t);
+    pending_.push_back(e.t);
+    st.presses++;
+}
+
+// Drains one device; a vanished device is closed and dropped
+void LAKeyReactive::readDevice(size_t k, LAKeyStats& st) {
+    input_event evs[64];
+    for (;;) {
+        ssize_t n = ::read(devices_[k].fd, evs, sizeof evs);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) return;
+        if (n <= 0) {
+            ::close(devices_[k].fd);
+            devices_[k].fd = -1;
+            return;
+        }
+        const double arrived = nowSec();
+        for (size_t i = 0; i < (size_t)n / sizeof(input_event); ++i) {
+            const input_event& ev = evs[i];
+            if (ev.type != EV_KEY) continue;
+            if (record_) std::fwrite(&ev, sizeof ev, 1, record_);
+            press(Event{ev.code, ev.value, devices_[k].kernelTime ? eventSec(ev) : arrived}, st);
+        }
+    }
+}
+
+// OUTPUT -----------------------------------------------------------
+
+bool LAKeyReactive::send(const LAFrameSink& sink, double now, LAKeyStats& st) {
+    LAParams p{LAEffect::Static, 1, brightness_, renderer_.render(now), LAWaveDir::None};
+
+    const auto t0 = Clock::now();
+    const double submitted = std::chrono::duration<double>(t0.time_since_epoch()).count();
+    for (double t : pending_) st.latency.add((uint64_t)(std::max(0.0, submitted - t) * 1e6));
+    pending_.clear();
+
+    bool ok = sink(p);
+    st.send.add((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count());
+    if (ok) { st.frames++; last_ = p.zones; shown_ = true; }
+    else    st.sendFailures++;
+    return ok;
+}
+
+void LAKeyReactive::stop() {
+    stop_.store(true);
+    stopFd_.raise();
+}
+
+static void armTimer(int fd, double sec, bool absolute, bool periodic) {
+    itimerspec its{};
+    its.it_value.tv_sec  = (time_t)sec;
+    its.it_value.tv_nsec = (long)((sec - std::floor(sec)) * 1e9);
+    if (periodic) its.it_interval = its.it_value;
+    timerfd_settime(fd, absolute ? TFD_TIMER_ABSTIME : 0, &its, nullptr);
+}
+
+static void disarmTimer(int fd) {
+    itimerspec its{};
+    timerfd_settime(fd, 0, &its, nullptr);
+}
+
+LAKeyStats LAKeyReactive::run(const LAFrameSink& sink) {
+    LAKeyStats st;
+    st.frameIntervalUs = 1e6 / fps_;
+    stop_.store(false);
+    stopFd_.drain();
+
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    int frameFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    int replayFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (ep < 0 || frameFd < 0 || replayFd < 0) {
+        for (int fd : {ep, frameFd, replayFd}) if (fd >= 0) ::close(fd);
+        return st;
+    }
+    auto watch = [ep](int fd, uint64_t tag) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = tag;
+        epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+    };
+    // Tags: devices by index, then the three fixed fds
+    const uint64_t kStop = UINT64_MAX, kFrame = UINT64_MAX - 1, kReplay = UINT64_MAX - 2;
+    for (size_t k = 0; k < devices_.size(); ++k) watch(devices_[k].fd, k);
+    watch(stopFd_.fd(), kStop);
+    watch(frameFd, kFrame);
+    watch(replayFd, kReplay);
+
+    const auto start = Clock::now();
+    const double cpu0 = laThreadCpuSec();
+    const double replayBase = nowSec() + 0.001;
+    auto due = [&](size_t i) { return replayBase + replay_[i].t / replaySpeed_; };
+    size_t next = 0;
+    bool ticking = false;
+    if (!replay_.empty() && replaySpeed_ > 0) armTimer(replayFd, due(0), true, false);
+
+    while (!stop_.load()) {
+        bool tick = false;
+        const bool live = std::any_of(devices_.begin(), devices_.end(), [](const Device& d){ return d.fd >= 0; });
+
+        if (next < replay_.size() && replaySpeed_ == 0) {
+            // Back to back: one event per pass, stamped when it is taken
+            Event e = replay_[next++];
+            e.t = nowSec();
+            press(e, st);
+        } else if (!live && next >= replay_.size() && !ticking) {
+            break;   // replay done and faded out
+        } else {
+            epoll_event evs[8];
+            int n = epoll_wait(ep, evs, 8, -1);
+            if (n < 0 && errno != EINTR) break;
+            for (int k = 0; k < n; ++k) {
+                const uint64_t tag = evs[k].data.u64;
+                uint64_t exp;
+                if (tag == kStop) {
+                    stop_.store(true);
+                } else if (tag == kFrame) {
+                    tick = ::read(frameFd, &exp, sizeof exp) == sizeof exp;
+                } else if (tag == kReplay) {
+                    if (::read(replayFd, &exp, sizeof exp) != sizeof exp) continue;
+                    const double now = nowSec();
+                    for (; next < replay_.size() && due(next) <= now; ++next) {
+                        Event e = replay_[next];
+                        e.t = due(next);
+                        press(e, st);
+                    }
+                    if (next < replay_.size()) armTimer(replayFd, due(next), true, false);
+                } else if (tag < devices_.size() && devices_[tag].fd >= 0) {
+                    readDevice(tag, st);   // closing a vanished device also unregisters it
+                }
+            }
+        }
+
+        // Presses go out now; fades only when a zone's color moved
+        const double now = nowSec();
+        if (!pending_.empty()) {
+            send(sink, now, st);
+        } else if (tick) {
+            LAZoneFrame f = renderer_.render(now);
+            if (!shown_ || std::memcmp(f.data(), last_.data(), sizeof f) != 0) send(sink, now, st);
+        }
+
+        // The tick that finds everything faded has just sent the base
+        // colors; after that the timer stays off until the next press
+        const bool active = renderer_.active(now);
+        if (active != ticking) {
+            if (active) armTimer(frameFd, 1.0 / fps_, false, true);
+            else        disarmTimer(frameFd);
+            ticking = active;
+        }
+    }
+
+    st.elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+    if (st.elapsedSec > 0) st.cpuFraction = (laThreadCpuSec() - cpu0) / st.elapsedSec;
+    if (record_) std::fflush(record_);
+    for (int fd : {ep, frameFd, replayFd}) ::close(fd);
+    return st;
+}
@@ -0,0 +1,145 @@
+// LegionAura/lib/reactive.h
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+#include "animation.h"
+#include "io_stats.h"
+#include "util.h"
+
+// ------------------------------------------------------
+// Linux keycode (KEY_*) -> zone 0..3, or -1 for keys that don't light
+// anything. laptop() is the 4-zone split of the Legion keyboards:
+// left block, middle block, right block with the arrows, numpad.
+// ------------------------------------------------------
+class LAKeyMap {
+public:
+    static constexpr int kCodes = 0x300;   // KEY_MAX + 1
+
+    LAKeyMap() { zone_.fill(-1); }
+    static LAKeyMap laptop();
+
+    int zone(uint16_t code) const { return code < kCodes ? zone_[code] : -1; }
+    void set(uint16_t code, int zone) { if (code < kCodes) zone_[code] = (int8_t)zone; }
+
+    // "30:1,57:4" (keycode:zone 1..4, zone 0 unmaps) on top of m
+    static bool parseOverrides(const std::string& s, LAKeyMap& m);
+
+private:
+    std::array<int8_t, kCodes> zone_;
+};
+
+enum class LAKeyEffect {
+    Flash,    // every zone flashes on any key
+    Ripple,   // the key's zone lights, neighbours follow rippleMs per zone later
+    Decay     // the key's zone glows; fast typing builds it up
+};
+
+// ------------------------------------------------------
+// Host-side renderer: key hits in, zone colors at time t out. Keeps the
+// last 32 hits; each fades over decayMs along (1 - dt/decay)^2, so a
+// settled keyboard is exactly the base color.
+// ------------------------------------------------------
+class LAKeyRenderer {
+public:
+    explicit LAKeyRenderer(LAKeyEffect effect = LAKeyEffect::Ripple) : effect_(effect) {}
+
+    void setEffect(LAKeyEffect e) { effect_ = e; }
+    void setColors(const LAZoneFrame& press, LAColor base) { press_ = press; base_ = base; }
+    void setDecayMs(double ms) { decay_ = std::max(1.0, ms) / 1000.0; }
+    void setRippleMs(double ms) { ripple_ = std::max(0.0, ms) / 1000.0; }
+
+    void hit(int zone, double t);         // t: seconds on any clock, as long as render() uses it too
+    LAZoneFrame render(double t) const;
+    bool active(double t) const;          // something still fading
+    void clear() { count_ = 0; }
+
+private:
+    struct Hit { int zone; double t; };
+    double span() const;                  // how long a hit affects the output
+
+    LAKeyEffect effect_;
+    LAZoneFrame press_{LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}, LAColor{255,255,255}};
+    LAColor base_{0,0,0};
+    double decay_ = 0.35, ripple_ = 0.06;
+    std::array<Hit,32> hits_{};
+    size_t next_ = 0, count_ = 0;
+};
+
+struct LAKeyStats {
+    uint64_t presses      = 0;   // key-down events on a mapped key
+    uint64_t unmapped     = 0;
+    uint64_t frames       = 0;   // sent: one per batch of presses, plus the fades
+    uint64_t sendFailures = 0;
+    LALatencyHistogram latency;  // event timestamp -> frame handed to the sink
+    LALatencyHistogram send;     // time inside the sink
+    double frameIntervalUs = 0;  // the budget latency should stay under
+    double elapsedSec = 0;
+    double cpuFraction = 0;      // thread CPU time / wall time, sends included
+};
+
+// ------------------------------------------------------
+// Key-reactive lighting from evdev. Presses are handled the moment
+// epoll reports the device readable: the renderer takes the hit, and a
+// frame goes to the sink right away instead of waiting for the next
+// frame tick. While something is fading, a timerfd ticks at fps; once
+// everything has settled the timer is disarmed and the loop sleeps.
+//
+// Latency is measured from the kernel's event timestamp (switched to
+// CLOCK_MONOTONIC with EVIOCSCLOCKID) to the sink call.
+//
+// Replay files are raw struct input_event records, as read from
+// /dev/input/eventN; record() writes the same thing. A replay is paced
+// by its timestamps through a second timerfd (speed 1 = as recorded,
+// 0 = back to back), and each replayed event is stamped with its due
+// time, so the latency numbers mean the same thing as for live input.
+// ------------------------------------------------------
+class LAKeyReactive {
+public:
+    LAKeyReactive(LAKeyRenderer& renderer, const LAKeyMap& map);
+    ~LAKeyReactive();
+    LAKeyReactive(const LAKeyReactive&) = delete;
+    LAKeyReactive& operator=(const LAKeyReactive&) = delete;
+
+    // /dev/input/event* nodes that have letter keys and a space bar
+    static std::vector<std::string> findKeyboards();
+
+    bool addDevice(const std::string& path, std::string& err);   // read only, not grabbed
+    bool openReplay(const std::string& path, double speed, std::string& err);
+    bool record(const std::string& path, std::string& err);      // key events of live devices
+
+    void setFps(double fps) { fps_ = fps > 0 ? fps : 60; }
+    void setBrightness(uint8_t b) { brightness_ = b; }
+
+    // Until stop(), or until a replay has finished and faded out when
+    // there are no live devices.
+    LAKeyStats run(const LAFrameSink& sink);
+    void stop();   // async-signal-safe
+
+private:
+    struct Event { uint16_t code; int32_t value; double t; };
+    struct Device { int fd; bool kernelTime; };   // kernelTime: timestamps are CLOCK_MONOTONIC
+
+    void press(const Event& e, LAKeyStats& st);
+    void readDevice(size_t k, LAKeyStats& st);
+    bool send(const LAFrameSink& sink, double now, LAKeyStats& st);
+
+    LAKeyRenderer& renderer_;
+    LAKeyMap map_;
+    std::vector<Device> devices_;
+    std::vector<Event> replay_;      // times relative to the first event
+    double replaySpeed_ = 1.0;
+    FILE* record_ = nullptr;
+    LAStopFd stopFd_;
+    std::atomic<bool> stop_{false};
+    double fps_ = 60;
+    uint8_t brightness_ = 2;
+    std::vector<double> pending_;    // timestamps of presses not sent yet
+    LAZoneFrame last_{};
+    bool shown_ = false;
+};
@@ -0,0 +1,455 @@
+// /LegionAura/lib/telemetry.cpp
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "telemetry.h"
+#include "color.h"
+#include "util.h"
+
+using Clock = std::chrono::steady_clock;
+
+// RAMPS ------------------------------------------------------------
+
+bool LAColorRamp::parse(const std::string& s, LAColorRamp& out) {
+    LAColorRamp r;
+    const bool ok = laForEachListItem(s, [&r](const std::string& item) {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos || colon == 0) return false;
+        const std::string num = item.substr(0, colon);
+        char* end = nullptr;
+        float v = std::strtof(num.c_str(), &end);
+        if (*end || !std::isfinite(v)) return false;
+        auto c = LegionAura::parseHexRGB(item.substr(colon + 1));
+        if (!c) return false;
+        if (!r.stops.empty() && v <= r.stops.back().value) return false;
+        r.stops.push_back({v, *c});
+        return true;
+    });
+    if (!ok || r.stops.empty()) return false;
+    out = std::move(r);
+    return true;
+}
+
+LAColorRamp LAColorRamp::forLoad() {
+    return {{{0.f, LAColor{0,255,0}}, {60.f, LAColor{255,255,0}}, {100.f, LAColor{255,0,0}}}};
+}
+
+LAColorRamp LAColorRamp::forTemp() {
+    return {{{40.f, LAColor{0,80,255}}, {70.f, LAColor{255,255,0}}, {95.f, LAColor{255,0,0}}}};
+}
+
+LAColor LAColorRamp::at(float v) const {
+    if (stops.empty()) return LAColor{0,0,0};
+    if (v <= stops.front().value) return stops.front().color;
+    if (v >= stops.back().value) return stops.back().color;
+
+    size_t k = 1;
+    while (stops[k].value < v) ++k;
+    const Stop& a = stops[k - 1];
+    const Stop& b = stops[k];
+    const float t = (v - a.value) / (b.value - a.value);
+    return laFromOklab(laLerp(laToOklab(a.color), laToOklab(b.color), t));
+}
+
+// METRICS ----------------------------------------------------------
+
+static bool allDigits(const std::string& s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](char c){ return c >= '0' && c <= '9'; });
+}
+
+bool LAMetricSpec::parse(const std::string& s, LAMetricSpec& out) {
+    LAMetricSpec m;
+    if (s == "cpu") {
+        m.kind = LAMetricKind::CpuLoad;
+    } else if (s.compare(0, 3, "cpu") == 0 && allDigits(s.substr(3)) && s.size() < 9) {
+        m.kind = LAMetricKind::CpuLoad;
+        m.cpu = std::atoi(s.c_str() + 3);
+    } else if (s == "pkg") {
+        m.kind = LAMetricKind::PackageTemp;
+    } else if (s.compare(0, 8, "thermal:") == 0 && s.size() > 8) {
+        m.kind = LAMetricKind::ThermalZone;
+        m.name = s.substr(8);
+    } else if (s.compare(0, 6, "hwmon:") == 0 && s.size() > 6) {
+        m.kind = LAMetricKind::Hwmon;
+        m.name = s.substr(6);
+    } else {
+        return false;
+    }
+    out = m;
+    return true;
+}
+
+std::string LAMetricSpec::str() const {
+    switch (kind) {
+        case LAMetricKind::CpuLoad:     return cpu < 0 ? "cpu" : "cpu" + std::to_string(cpu);
+        case LAMetricKind::PackageTemp: return "pkg";
+        case LAMetricKind::ThermalZone: return "thermal:" + name;
+        case LAMetricKind::Hwmon:       return "hwmon:" + name;
+    }
+    return "?";
+}
+
+// SYSFS LOOKUP -----------------------------------------------------
+// Only open() and available() walk the tree; ticks use the held fds.
+
+static std::string readLine(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+
+// "hwmon3", "thermal_zone0", ... under dir, in numeric order
+static std::vector<std::string> numberedEntries(const std::string& dir, const std::string& prefix) {
+    std::vector<std::string> out;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return out;
+    while (dirent* e = readdir(d)) {
+        const std::string name = e->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0 && allDigits(name.substr(prefix.size())))
+            out.push_back(name);
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end(), [&](const std::string& a, const std::string& b) {
+        return std::atoi(a.c_str() + prefix.size()) < std::atoi(b.c_str() + prefix.size());
+    });
+    return out;
+}
+
+static std::string thermalPath(const std::string& root, const std::string& zone) {
+    const std::string cls = root + "/sys/class/thermal/";
+    if (allDigits(zone)) {
+        const std::string p = cls + "thermal_zone" + zone + "/temp";
+        return access(p.c_str(), R_OK) == 0 ? p : "";
+    }
+    for (auto& z : numberedEntries(cls, "thermal_zone"))
+        if (readLine(cls + z + "/type") == zone) return cls + z + "/temp";
+    return "";
+}
+
+static std::string hwmonPath(const std::string& root, const std::string& chip) {
+    const std::string cls = root + "/sys/class/hwmon/";
+    for (auto& h : numberedEntries(cls, "hwmon"))
+        if (readLine(cls + h + "/name") == chip) {
+            const std::string p = cls + h + "/temp1_input";
+            if (access(p.c_str(), R_OK) == 0) return p;
+        }
+    return "";
+}
+
+// The tempN_input whose label is one of `labels`, in preference order
+static std::string labelledInput(const std::string& dir, std::initializer_list<const char*> labels) {
+    std::vector<std::pair<std::string,std::string>> found;   // label, input
+    for (int n = 1; n <= 64; ++n) {
+        const std::string base = dir + "/temp" + std::to_string(n);
+        std::string label = readLine(base + "_label");
+        if (!label.empty()) found.emplace_back(label, base + "_input");
+    }
+    for (const char* want : labels)
+        for (auto& f : found)
+            if (f.first == want) return f.second;
+    return "";
+}
+
+static std::string packagePath(const std::string& root) {
+    const std::string cls = root + "/sys/class/hwmon/";
+    for (auto& h : numberedEntries(cls, "hwmon")) {
+        const std::string name = readLine(cls + h + "/name");
+        std::string p;
+        if (name == "coretemp")
+            p = labelledInput(cls + h, {"Package id 0"});
+        else if (name == "k10temp" || name == "zenpower") {
+            p = labelledInput(cls + h, {"Tdie", "Tctl"});
+            if (p.empty()) p = cls + h + "/temp1_input";
+        }
+        if (!p.empty() && access(p.c_str(), R_OK) == 0) return p;
+    }
+    return thermalPath(root, "x86_pkg_temp");
+}
+
+std::vector<std::string> LATelemetry::available(const std::string& root) {
+    std::vector<std::string> out;
+    if (access((root + "/proc/stat").c_str(), R_OK) == 0) {
+        out.push_back("cpu");
+        std::ifstream f(root + "/proc/stat");
+        for (std::string line; std::getline(f, line) && line.compare(0, 3, "cpu") == 0;) {
+            std::string tag = line.substr(0, line.find(' '));
+            if (tag != "cpu") out.push_back(tag);
+        }
+    }
+    if (!packagePath(root).empty()) out.push_back("pkg");
+
+    const std::string thermal = root + "/sys/class/thermal/";
+    for (auto& z : numberedEntries(thermal, "thermal_zone")) {
+        const std::string type = readLine(thermal + z + "/type");
+        if (!type.empty() && thermalPath(root, type) == thermal + z + "/temp")
+            out.push_back("thermal:" + type);
+        else
+            out.push_back("thermal:" + z.substr(12));
+    }
+    const std::string hwmon = root + "/sys/class/hwmon/";
+    for (auto& h : numberedEntries(hwmon, "hwmon")) {
+        const std::string name = readLine(hwmon + h + "/name");
+        if (!name.empty() && hwmonPath(root, name) == hwmon + h + "/temp1_input" &&
+            std::find(out.begin(), out.end(), "hwmon:" + name) == out.end())
+            out.push_back("hwmon:" + name);
+    }
+    return out;
+}
+
+// ------------------------------------------------------
+
+LATelemetry::LATelemetry(std::string root) : root_(std::move(root)) {
+    LATelemetryZone load, temp;
+    temp.metric.kind = LAMetricKind::PackageTemp;
+    temp.ramp = LAColorRamp::forTemp();
+    zones_[0].cfg = zones_[1].cfg = load;
+    zones_[2].cfg = zones_[3].cfg = temp;
+}
+
+LATelemetry::~LATelemetry() {
+    close();
+}
+
+void LATelemetry::setZone(int zone, const LATelemetryZone& z) {
+    if (zone >= 0 && zone < 4) zones_[zone].cfg = z;
+}
+
+void LATelemetry::setSteps(unsigned steps) {
+    steps_ = std::clamp(steps, 2u, 256u);
+}
+
+void LATelemetry::close() {
+    for (auto& z : zones_) {
+        if (z.fd >= 0) ::close(z.fd);
+        z.fd = -1;
+    }
+    if (statFd_ >= 0) ::close(statFd_);
+    statFd_ = -1;
+}
+
+bool LATelemetry::resolve(Zone& z, std::string& err) {
+    const LAMetricSpec& m = z.cfg.metric;
+    std::string path;
+    switch (m.kind) {
+        case LAMetricKind::CpuLoad:     return true;   // shares statFd_
+        case LAMetricKind::PackageTemp: path = packagePath(root_); break;
+        case LAMetricKind::ThermalZone: path = thermalPath(root_, m.name); break;
+        case LAMetricKind::Hwmon:       path = hwmonPath(root_, m.name); break;
+    }
+    if (!path.empty()) z.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (z.fd < 0) {
+        err = "no sensor for " + m.str() + (path.empty() ? "" : " (" + path + ": " + std::strerror(errno) + ")");
+        return false;
+    }
+    return true;
+}
+
+void LATelemetry::buildLut(Zone& z) {
+    const float lo = z.cfg.ramp.lo(), hi = z.cfg.ramp.hi();
+    z.lut.resize(steps_);
+    for (unsigned k = 0; k < steps_; ++k)
+        z.lut[k] = z.cfg.ramp.at(lo + (hi - lo) * k / (steps_ - 1));
+}
+
+bool LATelemetry::open(std::string& err) {
+    close();
+    bool cpu = false;
+    for (auto& z : zones_) {
+        z.prevBusy = z.prevTotal = 0;
+        z.value = 0;
+        cpu = cpu || z.cfg.metric.kind == LAMetricKind::CpuLoad;
+        if (!resolve(z, err)) { close(); return false; }
+        buildLut(z);
+    }
+
+    if (cpu) {
+        const std::string path = root_ + "/proc/stat";
+        statFd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (statFd_ < 0) { err = path + ": " + std::strerror(errno); close(); return false; }
+        // The cpu lines come first; the rest (irq counts) can be long
+        statBuf_.resize(64 * 1024);
+    }
+
+    // Prime the load counters so the first tick measures one interval
+    const size_t len = readStat();
+    for (auto& z : zones_) {
+        bool ok = z.cfg.metric.kind == LAMetricKind::CpuLoad ? readCpu(z, statBuf_.data(), len) : readTemp(z);
+        if (!ok) {
+            err = z.cfg.metric.kind == LAMetricKind::CpuLoad ? z.cfg.metric.str() + " is not in " + root_ + "/proc/stat"
+                                                            : "cannot read " + z.cfg.metric.str();
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+// TICK -------------------------------------------------------------
+
+size_t LATelemetry::readStat() {
+    if (statFd_ < 0) return 0;
+    ssize_t n = pread(statFd_, statBuf_.data(), statBuf_.size() - 1, 0);
+    const size_t len = n > 0 ? (size_t)n : 0;
+    statBuf_[len] = '\0';
+    return len;
+}
+
+bool LATelemetry::readCpu(Zone& z, const char* stat, size_t len) {
+    char tag[16];
+    const int cpu = z.cfg.metric.cpu;
+    const int tagLen = cpu < 0 ? std::snprintf(tag, sizeof tag, "cpu ")
+                               : std::snprintf(tag, sizeof tag, "cpu%d ", cpu);
+
+    // "cpu3 user nice system idle iowait irq softirq steal ..."
+    const char* p = stat;
+    const char* end = stat + len;
+    while (p < end && std::strncmp(p, tag, tagLen) != 0) {
+        if (std::strncmp(p, "cpu", 3) != 0) return false;   // past the cpu lines
+        p = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!p) return false;
+        ++p;
+    }
+    if (p >= end) return false;
+    p += tagLen;
+
+    uint64_t f[8] = {};
+    for (auto& v : f) {
+        char* next;
+        v = std::strtoull(p, &next, 10);
+        p = next;
+    }
+    // guest time is already part of user time
+    const uint64_t idle  = f[3] + f[4];
+    const uint64_t total = f[0] + f[1] + f[2] + f[3] + f[4] + f[5] + f[6] + f[7];
+    const uint64_t busy  = total - idle;
+
+    if (total > z.prevTotal) {   // the priming read gives the average since boot
+        const uint64_t dBusy = busy >= z.prevBusy ? busy - z.prevBusy : 0;
+        z.value = 100.f * (float)dBusy / (float)(total - z.prevTotal);
+    }
+    z.prevBusy = busy;
+    z.prevTotal = total;
+    return true;
+}
+
+bool LATelemetry::readTemp(Zone& z) {
+    char buf[24];
+    ssize_t n = pread(z.fd, buf, sizeof buf - 1, 0);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+    z.value = (float)std::strtol(buf, nullptr, 10) / 1000.f;   // millidegrees
+    return true;
+}
+
+LAZoneFrame LATelemetry::sample(std::array<float,4>* values) {
+    const size_t len = readStat();
+
+    // A failed read keeps the zone's last value
+    LAZoneFrame out;
+    for (int k = 0; k < 4; ++k) {
+        Zone& z = zones_[k];
+        if (z.cfg.metric.kind == LAMetricKind::CpuLoad) {
+            if (len) readCpu(z, statBuf_.data(), len);
+        } else if (z.fd >= 0) {
+            readTemp(z);
+        }
+        const float lo = z.cfg.ramp.lo(), hi = z.cfg.ramp.hi();
+        const float t = hi > lo ? std::clamp((z.value - lo) / (hi - lo), 0.f, 1.f) : 0.f;
+        out[k] = z.lut.empty() ? LAColor{0,0,0} : z.lut[(size_t)std::lround(t * (z.lut.size() - 1))];
+        if (values) (*values)[k] = z.value;
+    }
+    return out;
+}
+
+// LOOP -------------------------------------------------------------
+
+void LATelemetry::stop() {
+    stop_.raise();
+}
+
+LATelemetryStats LATelemetry::run(const LAFrameSink& sink, uint64_t maxSamples) {
+    LATelemetryStats st;
+    stop_.drain();
+
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (tfd < 0 || ep < 0) {
+        if (tfd >= 0) ::close(tfd);
+        if (ep >= 0) ::close(ep);
+        return st;
+    }
+    itimerspec its{};
+    its.it_interval.tv_sec  = intervalMs_ / 1000;
+    its.it_interval.tv_nsec = (long)(intervalMs_ % 1000) * 1000000L;
+    its.it_value = its.it_interval;
+    timerfd_settime(tfd, 0, &its, nullptr);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = tfd;
+    epoll_ctl(ep, EPOLL_CTL_ADD, tfd, &ev);
+    ev.data.fd = stop_.fd();
+    epoll_ctl(ep, EPOLL_CTL_ADD, stop_.fd(), &ev);
+
+    LAParams p{LAEffect::Static, 1, brightness_, {}, LAWaveDir::None};
+    LAZoneFrame last{};
+    bool shown = false;
+    double sampleSum = 0;
+    const auto start = Clock::now();
+    const double cpu0 = laThreadCpuSec();
+
+    // First tick right away, so the keyboard doesn't wait an interval
+    bool running = true, due = true;
+    while (running) {
+        if (!due) {
+            epoll_event evs[2];
+            int n = epoll_wait(ep, evs, 2, -1);
+            if (n < 0 && errno != EINTR) break;
+            for (int k = 0; k < n; ++k) {
+                uint64_t exp = 0;
+                if (evs[k].data.fd == stop_.fd()) running = false;
+                else if (::read(tfd, &exp, sizeof exp) == sizeof exp) {
+                    due = true;
+                    st.missedTicks += exp - 1;
+                }
+            }
+            continue;
+        }
+        due = false;
+
+        auto t0 = Clock::now();
+        LAZoneFrame f = sample();
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        sampleSum += us;
+        st.sampleMaxUs = std::max(st.sampleMaxUs, us);
+        st.samples++;
+
+        if (!shown || std::memcmp(f.data(), last.data(), sizeof f) != 0) {
+            p.zones = f;
+            // On failure `last` stays put, so the next tick tries again
+            if (sink(p)) { st.applies++; last = f; shown = true; }
+            else         st.sendFailures++;
+        }
+        if (maxSamples && st.samples >= maxSamples) break;
+    }
+
+    st.elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+    if (st.samples) st.sampleMeanUs = sampleSum / st.samples;
+    if (st.elapsedSec > 0) st.cpuFraction = (laThreadCpuSec() - cpu0) / st.elapsedSec;
+    ::close(ep);
+    ::close(tfd);
+    return st;
+}
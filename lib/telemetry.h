@@ -0,0 +1,132 @@
+// LegionAura/lib/telemetry.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "legionaura.h"
+#include "animation.h"
+#include "util.h"
+
+// ------------------------------------------------------
+// Piecewise-linear color ramp over a metric's own units (% load or
+// degrees C), blended in OKLab. Values outside the stops clamp.
+// ------------------------------------------------------
+struct LAColorRamp {
+    struct Stop { float value; LAColor color; };
+    std::vector<Stop> stops;   // ascending by value
+
+    // "0:00ff00,60:ffff00,100:ff0000"
+    static bool parse(const std::string& s, LAColorRamp& out);
+    static LAColorRamp forLoad();   // green .. yellow .. red over 0..100 %
+    static LAColorRamp forTemp();   // blue .. yellow .. red over 40..95 C
+
+    LAColor at(float value) const;
+    float lo() const { return stops.empty() ? 0.f : stops.front().value; }
+    float hi() const { return stops.empty() ? 0.f : stops.back().value; }
+};
+
+// ------------------------------------------------------
+// What a zone shows:
+//   cpu               load over all CPUs (/proc/stat)
+//   cpuN              load of one CPU
+//   pkg               package temperature: coretemp "Package id 0",
+//                     k10temp Tctl/Tdie, else the x86_pkg_temp zone
+//   thermal:<n|type>  /sys/class/thermal/thermal_zone<n>, or the first
+//                     zone of that type (acpitz, iwlwifi_1, ...)
+//   hwmon:<name>      temp1_input of the first hwmon chip of that name
+// ------------------------------------------------------
+enum class LAMetricKind { CpuLoad, PackageTemp, ThermalZone, Hwmon };
+
+struct LAMetricSpec {
+    LAMetricKind kind = LAMetricKind::CpuLoad;
+    int cpu = -1;        // CpuLoad: -1 = all
+    std::string name;    // ThermalZone / Hwmon
+
+    static bool parse(const std::string& s, LAMetricSpec& out);
+    std::string str() const;
+    bool isTemperature() const { return kind != LAMetricKind::CpuLoad; }
+};
+
+struct LATelemetryZone {
+    LAMetricSpec metric;
+    LAColorRamp  ramp = LAColorRamp::forLoad();
+};
+
+struct LATelemetryStats {
+    uint64_t samples      = 0;
+    uint64_t applies      = 0;    // ticks whose quantized colors changed
+    uint64_t sendFailures = 0;
+    uint64_t missedTicks  = 0;    // timer expirations we slept through
+    double   sampleMeanUs = 0;    // pread + parse + lookup, per tick
+    double   sampleMaxUs  = 0;
+    double   elapsedSec   = 0;
+    double   cpuFraction  = 0;    // thread CPU time / wall time, sends included
+};
+
+// ------------------------------------------------------
+// Machine state on the 4 zones. open() resolves every source once and
+// keeps its file open; each tick re-reads them with pread() at offset 0
+// (procfs and sysfs regenerate the contents on every read), so a tick
+// is a handful of syscalls with no path lookups or allocation. Ticks
+// come from a timerfd in an epoll loop; stop() wakes it through an
+// eventfd, so it is safe from a signal handler.
+//
+// Each ramp is pre-rendered into `steps` colors. A tick maps its value
+// to the nearest step, and the sink is only called when one of the
+// zones lands on a different color than last time.
+//
+// `root` prefixes /proc and /sys: empty on a real system, a fake tree
+// in tests.
+// ------------------------------------------------------
+class LATelemetry {
+public:
+    explicit LATelemetry(std::string root = "");
+    ~LATelemetry();
+    LATelemetry(const LATelemetry&) = delete;
+    LATelemetry& operator=(const LATelemetry&) = delete;
+
+    void setZone(int zone, const LATelemetryZone& z);   // zone 0..3
+    void setIntervalMs(unsigned ms) { intervalMs_ = ms ? ms : 1; }
+    void setSteps(unsigned steps);                      // 2..256 colors per ramp
+    void setBrightness(uint8_t b) { brightness_ = b; }
+
+    // Resolves and opens every source; err names the one that is missing.
+    bool open(std::string& err);
+    void close();
+
+    // One tick without the timer: re-read, map, quantize. values gets the
+    // raw readings (% or C).
+    LAZoneFrame sample(std::array<float,4>* values = nullptr);
+
+    // Ticks every interval until stop() (or maxSamples ticks, if non-zero)
+    LATelemetryStats run(const LAFrameSink& sink, uint64_t maxSamples = 0);
+    void stop();
+
+    // Every metric spec that resolves under root, for --list
+    static std::vector<std::string> available(const std::string& root = "");
+
+private:
+    struct Zone {
+        LATelemetryZone cfg;
+        int fd = -1;                     // temperature file; cpu zones use statFd_
+        uint64_t prevBusy = 0, prevTotal = 0;
+        float value = 0;
+        std::vector<LAColor> lut;        // steps_ colors over [lo, hi]
+    };
+
+    bool resolve(Zone& z, std::string& err);
+    void buildLut(Zone& z);
+    size_t readStat();                   // /proc/stat into statBuf_, NUL-terminated
+    bool readCpu(Zone& z, const char* stat, size_t len);
+    bool readTemp(Zone& z);
+
+    std::string root_;
+    std::array<Zone,4> zones_;
+    int statFd_ = -1;
+    LAStopFd stop_;
+    unsigned intervalMs_ = 1000;
+    unsigned steps_ = 32;
+    uint8_t brightness_ = 2;
+    std::vector<char> statBuf_;
+};
@@ -0,0 +1,196 @@
+// /LegionAura/lib/timeline.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "timeline.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "timeline files are little-endian and used in place"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr char kMagic[4] = {'L', 'A', 'T', 'L'};
+
+// BUILDER ----------------------------------------------------------
+
+bool LATimelineBuilder::add(uint64_t atUs, const LAPacket& packet) {
+    if (!frames_.empty() && atUs < lastUs_) return false;
+
+    uint64_t gap = frames_.empty() ? atUs : atUs - lastUs_;
+    while (gap > UINT32_MAX) {
+        // Hold the previous frame (or off, before the first) across the gap
+        LATimelineFrame hold{UINT32_MAX, frames_.empty() ? kLAPacketOff : frames_.back().packet};
+        frames_.push_back(hold);
+        gap -= UINT32_MAX;
+    }
+    frames_.push_back(LATimelineFrame{(uint32_t)gap, packet});
+    lastUs_ = atUs;
+    return true;
+}
+
+bool LATimelineBuilder::end(uint64_t atUs) {
+    if (atUs < lastUs_) return false;
+    endUs_ = atUs;
+    return true;
+}
+
+bool LATimelineBuilder::save(const std::string& path, std::string& err) const {
+    const uint64_t endUs = durationUs();
+    if (endUs - lastUs_ > UINT32_MAX) { err = "hold after the last frame is too long"; return false; }
+
+    LATimelineHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof kMagic);
+    h.version    = LA_TIMELINE_VERSION;
+    h.flags      = loop_ ? LA_TIMELINE_LOOP : 0;
+    h.frameCount = (uint32_t)frames_.size();
+    h.tailUs     = (uint32_t)(endUs - lastUs_);
+    h.durationUs = endUs;
+
+    const std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) { err = "cannot write " + tmp; return false; }
+    bool ok = std::fwrite(&h, sizeof h, 1, f) == 1;
+    if (ok && !frames_.empty())
+        ok = std::fwrite(frames_.data(), sizeof(LATimelineFrame), frames_.size(), f) == frames_.size();
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        err = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+// MAPPING ----------------------------------------------------------
+
+LATimeline::~LATimeline() {
+    close();
+}
+
+bool LATimeline::open(const std::string& path, std::string& err) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { err = "cannot read " + path; return false; }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LATimelineHeader)) {
+        ::close(fd);
+        err = path + ": not a timeline";
+        return false;
+    }
+
+    void* m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping keeps the file
+    if (m == MAP_FAILED) { err = "cannot map " + path; return false; }
+
+    map_ = m;
+    size_ = (size_t)st.st_size;
+
+    const LATimelineHeader& h = header();
+    if (std::memcmp(h.magic, kMagic, sizeof kMagic) != 0) err = path + ": not a timeline";
+    else if (h.version != LA_TIMELINE_VERSION) err = path + ": unsupported timeline version " + std::to_string(h.version);
+    else if (size_ != sizeof(LATimelineHeader) + (size_t)h.frameCount * sizeof(LATimelineFrame))
+        err = path + ": truncated or corrupt";
+    if (!err.empty()) { close(); return false; }
+
+    madvise(map_, size_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void LATimeline::close() {
+    if (map_) munmap(map_, size_);
+    map_ = nullptr;
+    size_ = 0;
+}
+
+void LATimeline::release(size_t from, size_t to) const {
+    static const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    const uintptr_t base = (uintptr_t)frames();
+    // Whole pages only, so frames outside the range stay mapped in
+    uintptr_t a = (base + from * sizeof(LATimelineFrame) + page - 1) & ~(page - 1);
+    uintptr_t b = (base + to * sizeof(LATimelineFrame)) & ~(page - 1);
+    if (b > a) madvise((void*)a, b - a, MADV_DONTNEED);
+}
+
+// PLAYBACK ---------------------------------------------------------
+
+static double usBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+// Delays can be minutes long; wake up now and then to notice stop()
+static bool waitUntil(Clock::time_point t, const std::atomic<bool>& stop) {
+    constexpr auto kSlice = std::chrono::milliseconds(100);
+    for (auto now = Clock::now(); now < t; now = Clock::now()) {
+        if (stop.load()) return false;
+        std::this_thread::sleep_until(std::min(t, now + kSlice));
+    }
+    return !stop.load();
+}
+
+LAPlayStats LATimelinePlayer::run(const LAPacketSink& sink, bool loop) {
+    LAPlayStats st;
+    stop_.store(false);
+    loop = loop || tl_.loops();
+
+    const LATimelineFrame* f = tl_.frames();
+    const size_t n = tl_.frameCount();
+    const LATimelineHeader& h = tl_.header();
+    if (!n) return st;
+
+    // Release pages behind the cursor about every 256 KiB
+    constexpr size_t kReleaseEvery = (256 * 1024) / sizeof(LATimelineFrame);
+
+    const auto start = Clock::now();
+    auto due = start;
+    double lateSum = 0;
+
+    while (!stop_.load()) {
+        size_t released = 0;
+        for (size_t i = 0; i < n; ++i) {
+            due += std::chrono::microseconds(f[i].delayUs);
+            if (!waitUntil(due, stop_)) break;
+
+            const auto now = Clock::now();
+            if (i + 1 < n && now >= due + std::chrono::microseconds(f[i + 1].delayUs)) {
+                st.framesDropped++;
+                continue;
+            }
+
+            const double late = usBetween(due, now);
+            lateSum += late;
+            st.lateMaxUs = std::max(st.lateMaxUs, late);
+
+            if (sink(f[i].packet)) st.framesSent++;
+            else                   st.sendFailures++;
+
+            if (i - released >= kReleaseEvery) {
+                tl_.release(released, i);
+                released = i;
+            }
+        }
+        if (stop_.load()) break;
+
+        tl_.release(released, n);
+        due += std::chrono::microseconds(h.tailUs);
+        if (!waitUntil(due, stop_)) break;
+        st.loops++;
+        if (!loop || h.durationUs == 0) break;
+    }
+
+    const uint64_t attempts = st.framesSent + st.sendFailures;
+    st.elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+    if (attempts) st.lateMeanUs = lateSum / attempts;
+    return st;
+}
@@ -0,0 +1,133 @@
+// LegionAura/lib/timeline.h
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "packet.h"
+
+// ------------------------------------------------------
+// Compiled animation timeline (.latl). Everything is decided when the
+// file is built: each frame is a finished SET_REPORT body plus the delay
+// since the previous frame, so playback only sleeps and sends. Colors
+// are as requested, like saved profiles: the player's sink applies the
+// model's color correction (LegionAura::applyEncoded), which passes the
+// packet through untouched when there is none.
+//
+//   header   LATimelineHeader (32 bytes)
+//   frames   LATimelineFrame[frameCount] (36 bytes each)
+//
+// Fields are little-endian. The file is mapped, not read, so a long
+// sequence opens instantly and the player touches each page once.
+// ------------------------------------------------------
+constexpr uint32_t LA_TIMELINE_VERSION = 1;
+constexpr uint32_t LA_TIMELINE_LOOP    = 1u << 0;   // header flag: repeat until stopped
+
+struct LATimelineHeader {
+    char     magic[4];      // "LATL"
+    uint32_t version;       // LA_TIMELINE_VERSION
+    uint32_t flags;         // LA_TIMELINE_*
+    uint32_t frameCount;
+    uint32_t tailUs;        // hold after the last frame (one loop = durationUs)
+    uint32_t reserved;
+    uint64_t durationUs;
+};
+
+struct LATimelineFrame {
+    uint32_t delayUs;       // since the previous frame; the first one since start
+    LAPacket packet;
+};
+
+static_assert(sizeof(LATimelineHeader) == 32, "timeline header layout");
+static_assert(sizeof(LATimelineFrame) == 36, "timeline frame layout");
+
+// ------------------------------------------------------
+// Builds a timeline in memory and writes it out. Frames are added at
+// absolute times (microseconds from start) in non-decreasing order;
+// gaps too long for a 32-bit delay are bridged by repeating the frame.
+// ------------------------------------------------------
+class LATimelineBuilder {
+public:
+    bool add(uint64_t atUs, const LAPacket& packet);   // false if earlier than the last frame
+    bool end(uint64_t atUs);                            // total length; default: the last frame
+    void setLoop(bool on) { loop_ = on; }
+
+    size_t frames() const { return frames_.size(); }
+    uint64_t durationUs() const { return std::max(endUs_, lastUs_); }
+
+    bool save(const std::string& path, std::string& err) const;   // via a temp file + rename
+
+private:
+    std::vector<LATimelineFrame> frames_;
+    uint64_t lastUs_ = 0;
+    uint64_t endUs_ = 0;
+    bool loop_ = false;
+};
+
+// ------------------------------------------------------
+// Read-only mapping of a .latl file. Validates the header and size on
+// open; the frames are then used in place.
+// ------------------------------------------------------
+class LATimeline {
+public:
+    LATimeline() = default;
+    ~LATimeline();
+    LATimeline(const LATimeline&) = delete;
+    LATimeline& operator=(const LATimeline&) = delete;
+
+    bool open(const std::string& path, std::string& err);
+    void close();
+    bool isOpen() const { return map_ != nullptr; }
+
+    const LATimelineHeader& header() const { return *static_cast<const LATimelineHeader*>(map_); }
+    const LATimelineFrame* frames() const {
+        return reinterpret_cast<const LATimelineFrame*>(static_cast<const char*>(map_) + sizeof(LATimelineHeader));
+    }
+    size_t frameCount() const { return header().frameCount; }
+    bool loops() const { return header().flags & LA_TIMELINE_LOOP; }
+
+    // Drop the mapped pages of frames [from, to) from memory. The player
+    // calls this behind itself so memory stays flat however long the file is.
+    void release(size_t from, size_t to) const;
+
+private:
+    void* map_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct LAPlayStats {
+    uint64_t framesSent    = 0;
+    uint64_t framesDropped = 0;   // skipped because the next frame was already due
+    uint64_t sendFailures  = 0;
+    uint64_t loops         = 0;   // completed passes
+    double   elapsedSec    = 0;
+    double   lateMeanUs    = 0;   // send start minus due time
+    double   lateMaxUs     = 0;
+};
+
+// Where packets go: LegionAura::sendPacket, a device group, ...
+using LAPacketSink = std::function<bool(const LAPacket&)>;
+
+// ------------------------------------------------------
+// Plays a mapped timeline on absolute deadlines (start + sum of delays),
+// so timing errors don't accumulate. A frame whose successor is already
+// due when it comes up is dropped rather than sent late. No parsing or
+// allocation happens while playing.
+// ------------------------------------------------------
+class LATimelinePlayer {
+public:
+    explicit LATimelinePlayer(const LATimeline& tl) : tl_(tl) {}
+
+    // loop: repeat (also when the file's loop flag is set) until stop()
+    LAPlayStats run(const LAPacketSink& sink, bool loop = false);
+
+    // Safe to call from another thread or a signal handler.
+    void stop() { stop_.store(true); }
+
+private:
+    const LATimeline& tl_;
+    std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,90 @@
+// /LegionAura/lib/transition.cpp
+
+#include <algorithm>
+#include <thread>
+
+#include "legionaura.h"
+#include "color.h"
+#include "packet.h"
+
+using Clock = std::chrono::steady_clock;
+
+// ------------------------------------------------------
+// Timed fades. Both ends are in device colors (after the color
+// pipeline), since that is what the shadow state and readState hold.
+// Transfers are synchronous, so there is never more than one in flight;
+// the next frame is due one smoothed round trip (plus a quarter for the
+// controller to settle) after the previous one started, but no sooner
+// than kMinFramePeriod, and the final packet starts one round trip
+// before the deadline. Each frame is rendered for the time it is
+// actually sent, so a slow send shortens the step count instead of
+// pushing the end of the fade back.
+// ------------------------------------------------------
+
+static constexpr auto kMinFramePeriod = std::chrono::milliseconds(10);
+
+bool LegionAura::currentColors(LAParams& out) {
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        if (shadowValid_) return laDecode(shadow_.data(), shadow_.size(), out);
+    }
+    return readState(out);
+}
+
+bool LegionAura::transition(const LAParams& to, std::chrono::milliseconds duration) {
+    LATransition fade(*this, to, duration);
+    while (!fade.done()) {
+        std::this_thread::sleep_until(fade.due());
+        fade.step();
+    }
+    return fade.ok();
+}
+
+LATransition::LATransition(LegionAura& kb, const LAParams& to, std::chrono::milliseconds duration)
+    : kb_(kb), to_(to), target_(kb.corrected(to)),
+      start_(Clock::now()), end_(start_ + duration), due_(start_)
+{
+    LAParams from;
+    if (duration.count() <= 0 || !LAZoneFade::canFade(target_.effect) ||
+        !kb_.currentColors(from) || !LAZoneFade::canFade(from.effect))
+        return;
+
+    kb_.setRequested(to);
+    fade_ = std::make_unique<LAZoneFade>(from, target_);
+}
+
+LATransition::~LATransition() = default;
+
+// The last transfer is `to` itself and should land at end_
+LATransition::Clock::time_point LATransition::lastSlot() const {
+    return end_ - std::chrono::microseconds(kb_.rttUs_.load());
+}
+
+bool LATransition::step() {
+    if (done_) return ok_;
+
+    if (!fade_) {
+        done_ = true;
+        return ok_ = kb_.apply(to_);
+    }
+
+    const auto now = Clock::now();
+    if (now >= lastSlot()) {
+        done_ = true;
+        return ok_ = kb_.send(laEncode(target_));
+    }
+
+    const float t = std::chrono::duration<float>(now - start_) /
+                    std::chrono::duration<float>(end_ - start_);
+    // Identical consecutive frames are dropped by the shadow check
+    if (!kb_.send(laEncode(fade_->at(t)))) {
+        done_ = true;
+        return ok_ = false;
+    }
+
+    const uint32_t rtt = kb_.rttUs_.load();
+    const auto period = std::max<Clock::duration>(kMinFramePeriod,
+                            std::chrono::microseconds(rtt + rtt / 4));
+    due_ = std::min(now + period, lastSlot());
+    return true;
+}
@@ -0,0 +1,45 @@
+// /LegionAura/lib/update.cpp
+
+#include <algorithm>
+
+#include "legionaura.h"
+#include "packet.h"
+
+// ------------------------------------------------------
+// Read-modify-write of single fields. The base is the shadow state (the
+// last payload the device accepted), decoded back to params, so changing
+// one field costs one SET_REPORT. Both the base and the corrected request
+// are in device colors, so zones merge without going through the color
+// pipeline twice.
+// ------------------------------------------------------
+
+static void mergeFields(LAParams& into, uint32_t fields, const LAParams& from) {
+    if (fields & LA_FIELD_EFFECT)     into.effect = from.effect;
+    if (fields & LA_FIELD_SPEED)      into.speed = from.speed;
+    if (fields & LA_FIELD_BRIGHTNESS) into.brightness = from.brightness;
+    if (fields & LA_FIELD_WAVE_DIR)   into.waveDir = from.waveDir;
+    for (int z = 0; z < 4; ++z)
+        if (fields & (LA_FIELD_ZONE0 << z)) into.zones[z] = from.zones[z];
+}
+
+bool LegionAura::update(uint32_t fields, const LAParams& p) {
+    if (!isOpen()) return false;
+    if ((fields & LA_FIELD_ALL) == LA_FIELD_ALL) return apply(p);
+
+    LAParams cur;
+    if (!currentColors(cur)) return false;   // cold cache and the read failed
+    mergeFields(cur, fields, corrected(p));
+
+    // The uncorrected state gets the same fields, before correction
+    {
+        std::lock_guard<std::mutex> lk(shadowMtx_);
+        if (requested_) mergeFields(*requested_, fields, p);
+    }
+    return send(laEncode(cur));
+}
+
+bool LegionAura::setBrightnessOnly(uint8_t level) {
+    LAParams p{};
+    p.brightness = std::clamp<uint8_t>(level, 1, 2);
+    return update(LA_FIELD_BRIGHTNESS, p);
+}
@@ -0,0 +1,60 @@
+// LegionAura/lib/util.h
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// ------------------------------------------------------
+// CPU time this thread has used, in seconds. The run() loops divide it
+// by wall time for their cpuFraction.
+// ------------------------------------------------------
+inline double laThreadCpuSec() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ------------------------------------------------------
+// Wakes an epoll loop from another thread or a signal handler: raise()
+// is a single write() to an eventfd. A loop calls drain() before it
+// starts, so a stop() that arrived while nothing was running doesn't end
+// the next run at once.
+// ------------------------------------------------------
+class LAStopFd {
+public:
+    LAStopFd() : fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+    ~LAStopFd() { if (fd_ >= 0) ::close(fd_); }
+    LAStopFd(const LAStopFd&) = delete;
+    LAStopFd& operator=(const LAStopFd&) = delete;
+
+    int fd() const { return fd_; }
+    void raise() {   // async-signal-safe
+        uint64_t one = 1;
+        if (fd_ >= 0) (void)!::write(fd_, &one, sizeof one);
+    }
+    void drain() {
+        uint64_t n;
+        while (fd_ >= 0 && ::read(fd_, &n, sizeof n) > 0) {}
+    }
+
+private:
+    int fd_;
+};
+
+// ------------------------------------------------------
+// Calls item(std::string) for each comma-separated field of s, empty
+// ones included; stops and returns false as soon as item does.
+// ------------------------------------------------------
+template <class F>
+bool laForEachListItem(const std::string& s, F&& item) {
+    size_t pos = 0;
+    while (pos <= s.size()) {
+        size_t comma = s.find(',', pos);
+        if (comma == std::string::npos) comma = s.size();
+        if (!item(s.substr(pos, comma - pos))) return false;
+        pos = comma + 1;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+// /LegionAura/lib/writer.cpp
+
+#include <chrono>
+
+#include "legionaura.h"
+#include "frame_mailbox.h"
+
+// ------------------------------------------------------
+// USB writer thread behind post(). Frames are encoded (and color
+// corrected) on the producer's thread, so the writer only pulls the
+// newest packet out of the mailbox and blocks in the transfer. Its
+// busy time gives the rate the controller sustains, independent of how
+// fast frames are produced.
+// ------------------------------------------------------
+
+bool LegionAura::post(const LAParams& p) {
+    if (!isOpen()) return false;
+
+    {
+        std::lock_guard<std::mutex> lk(writerMtx_);
+        if (!writer_.joinable()) {
+            mailbox_->reopen();
+            writer_ = std::thread(&LegionAura::writerLoop, this);
+        }
+    }
+
+    setRequested(p);
+    mailbox_->post(laEncode(corrected(p)));
+    return true;
+}
+
+void LegionAura::writerLoop() {
+    LAPacket pkt;
+    while (mailbox_->wait(pkt)) {
+        bool suppressed = false;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = send(pkt, &suppressed);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t0).count();
+
+        // Frames equal to the shadow state never reach the device and
+        // would inflate the device rate
+        if (suppressed) {
+            wrUnchanged_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        wrBusyNs_.fetch_add((uint64_t)ns, std::memory_order_relaxed);
+        wrWritten_.fetch_add(1, std::memory_order_relaxed);
+        if (!ok) wrFailures_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// The next post() starts the writer again
+void LegionAura::flushPosted() {
+    stopWriter();
+}
+
+void LegionAura::cancelPosted() {
+    LAPacket stale;
+    mailbox_->take(stale);
+    stopWriter();
+}
+
+void LegionAura::stopWriter() {
+    std::lock_guard<std::mutex> lk(writerMtx_);
+    if (!writer_.joinable()) return;
+    mailbox_->close();
+    writer_.join();
+}
+
+LAMailboxCounters LegionAura::mailboxCounters() const {
+    LAMailboxCounters c;
+    c.posted    = mailbox_->posted();
+    c.coalesced = mailbox_->coalesced();
+    c.written   = wrWritten_.load(std::memory_order_relaxed);
+    c.unchanged = wrUnchanged_.load(std::memory_order_relaxed);
+    c.failures  = wrFailures_.load(std::memory_order_relaxed);
+    c.busySec   = wrBusyNs_.load(std::memory_order_relaxed) / 1e9;
+    return c;
+}